@@ -29,9 +29,17 @@
 #include "Sound.hxx"
 #include "M6532.hxx"
 #include "Version.hxx"
+#include "Profiler.hxx"
 
 #include "Stubs.hxx"
 
+#ifdef STELLA_PROFILE
+/* Number of frames between profiler reports */
+#ifndef STELLA_PROFILE_INTERVAL
+#define STELLA_PROFILE_INTERVAL 300
+#endif
+#endif
+
 #ifdef _3DS
 extern "C" void* linearMemAlign(size_t size, size_t alignment);
 extern "C" void linearFree(void* mem);
@@ -206,11 +214,16 @@ static Event::Type MouseButtonValue1 = Event::MouseButtonRightValue;
 static float stelladaptor_analog_sensitivity = 1.0f;
 static float stelladaptor_analog_center      = 0.0f;
 
+/* Audio output rate, and number of samples produced per frame */
+static uint32_t audio_rate              = 31400;
+static uint32_t audio_samples_per_frame = 0;
+
+/* Generate the sound on a thread of its own */
+static bool audio_thread = false;
+
 /* Low pass audio filter */
 static bool low_pass_enabled       = false;
 static int32_t low_pass_range      = 0;
-static int32_t low_pass_left_prev  = 0;
-static int32_t low_pass_right_prev = 0;
 
 static retro_log_printf_t log_cb;
 static retro_video_refresh_t video_cb;
@@ -221,6 +234,7 @@ static retro_audio_sample_t audio_cb;
 static retro_audio_sample_batch_t audio_batch_cb;
 
 static bool libretro_supports_bitmasks = false;
+static bool libretro_supports_dupe     = false;
 
 /************************************
  * Interframe blending
@@ -347,22 +361,32 @@ static void convert_palette(const uint32_t *palette32, uint16_t *palette16)
    }
 }
 
-static void blend_frames_null_16(uInt8 *stella_fb, int width, int height)
+/* Answers the palette in the output pixel format */
+static const void *get_output_palette(void)
 {
    const uint32_t *palette32 = console->getPalette(0);
-   uint16_t *palette16       = currentPalette16;
-   uInt8 *in                 = stella_fb;
-   uint16_t *out             = (uint16_t*)frameBuffer;
-   int i;
+
+   if (framePixelBytes == 4)
+      return palette32;
 
    /* If palette has changed, re-cache converted
     * RGB565 values */
    if (palette32 != currentPalette32)
    {
       currentPalette32 = palette32;
-      convert_palette(palette32, palette16);
+      convert_palette(palette32, currentPalette16);
    }
 
+   return currentPalette16;
+}
+
+static void blend_frames_null_16(uInt8 *stella_fb, int width, int height)
+{
+   const uint16_t *palette16 = (const uint16_t*)get_output_palette();
+   uInt8 *in                 = stella_fb;
+   uint16_t *out             = (uint16_t*)frameBuffer;
+   int i;
+
    for (i = 0; i < width * height; i++)
       *(out++) = *(palette16 + *(in++));
 }
@@ -478,6 +502,12 @@ static void blend_frames_ghost95_32(uInt8 *stella_fb, int width, int height)
 static void (*blend_frames_16)(uInt8 *stella_fb, int width, int height) = blend_frames_null_16;
 static void (*blend_frames_32)(uInt8 *stella_fb, int width, int height) = blend_frames_null_32;
 
+/* When enabled (and not blending), the TIA converts each piece of a
+ * scanline into frameBuffer as it draws it, instead of the whole frame
+ * being converted afterwards (see TIA::setDirectOutput()) */
+static bool direct_video_enabled = false;
+static bool direct_video         = false;
+
 static void init_frame_blending(enum frame_blend_method blend_method)
 {
    /* Allocate/zero out buffer, if required */
@@ -520,80 +550,62 @@ static void init_frame_blending(enum frame_blend_method blend_method)
          blend_frames_32 = blend_frames_null_32;
          break;
    }
+
+   direct_video = direct_video_enabled && (blend_method == FRAME_BLEND_NONE);
 }
 
 /************************************
- * Low pass audio filter
+ * Frameskip
  ************************************/
 
-static void apply_low_pass_filter_mono(int16_t *buf, int length)
+enum frameskip_type
 {
-   int samples      = length;
-   int16_t *out     = buf;
-
-   /* Restore previous sample */
-   int32_t low_pass = low_pass_left_prev;
-
-   /* Single-pole low-pass filter (6 dB/octave) */
-   int32_t factor_a = low_pass_range;
-   int32_t factor_b = 0x10000 - factor_a;
-
-   do
-   {
-      /* Apply low-pass filter */
-      low_pass = (low_pass * factor_a) + (*out * factor_b);
-
-      /* 16.16 fixed point */
-      low_pass >>= 16;
+   FRAMESKIP_NONE = 0,
+   FRAMESKIP_FASTFORWARD,
+   FRAMESKIP_FIXED
+};
 
-      /* Update sound buffer
-       * > Converted to stereo by duplicating
-       *   the left/right channels */
-      *out++   = (int16_t)low_pass;
-      *out++   = (int16_t)low_pass;
-   }
-   while (--samples);
+/* While fast-forwarding, one frame in this many is drawn */
+#define FRAMESKIP_FASTFORWARD_INTERVAL 4
 
-   /* Save last sample for next frame */
-   low_pass_left_prev = low_pass;
-}
+static enum frameskip_type frameskip_type = FRAMESKIP_NONE;
+static unsigned frameskip_interval        = 1;
+static unsigned frameskip_counter         = 0;
 
-static void apply_low_pass_filter_stereo(int16_t *buf, int length)
+/* Decides whether the coming frame is emulated without drawing it */
+static bool frameskip_check(void)
 {
-   int samples            = length;
-   int16_t *out           = buf;
+   int av_enable        = 0;
+   bool fast_forwarding = false;
+   unsigned interval    = 1;
 
-   /* Restore previous samples */
-   int32_t low_pass_left  = low_pass_left_prev;
-   int32_t low_pass_right = low_pass_right_prev;
-
-   /* Single-pole low-pass filter (6 dB/octave) */
-   int32_t factor_a       = low_pass_range;
-   int32_t factor_b       = 0x10000 - factor_a;
+   /* Frontend has no use for the video of this frame (e.g. run-ahead) */
+   if (environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable) &&
+       !(av_enable & 1))
+      return true;
 
-   do
+   switch (frameskip_type)
    {
-      /* Apply low-pass filter */
-      low_pass_left  = (low_pass_left  * factor_a) + (*out       * factor_b);
-      low_pass_right = (low_pass_right * factor_a) + (*(out + 1) * factor_b);
-
-      /* 16.16 fixed point */
-      low_pass_left  >>= 16;
-      low_pass_right >>= 16;
-
-      /* Update sound buffer */
-      *out++ = (int16_t)low_pass_left;
-      *out++ = (int16_t)low_pass_right;
+      case FRAMESKIP_FASTFORWARD:
+         if (environ_cb(RETRO_ENVIRONMENT_GET_FASTFORWARDING, &fast_forwarding) &&
+             fast_forwarding)
+            interval = FRAMESKIP_FASTFORWARD_INTERVAL;
+         break;
+      case FRAMESKIP_FIXED:
+         interval = frameskip_interval;
+         break;
+      default:
+         break;
    }
-   while (--samples);
 
-   /* Save last samples for next frame */
-   low_pass_left_prev  = low_pass_left;
-   low_pass_right_prev = low_pass_right;
+   if (++frameskip_counter >= interval)
+   {
+      frameskip_counter = 0;
+      return false;
+   }
+   return true;
 }
 
-static void (*apply_low_pass_filter)(int16_t *buf, int length) = apply_low_pass_filter_mono;
-
 /************************************
  * Auxiliary functions
  ************************************/
@@ -665,6 +677,10 @@ static void init_paddles(void)
    }
 }
 
+/* Number of scanlines after which the input is read again while a frame
+ * is emulated, or 0 to only read it before the frame */
+static unsigned input_poll_lines = 0;
+
 static void update_input()
 {
    unsigned i;
@@ -839,7 +855,7 @@ static void check_variables(bool first_run)
    int stelladaptor_sensitivity;
    int stelladaptor_center;
 
-   /* Only read colour depth option on first run */
+   /* Only read colour depth and audio rate/thread options on first run */
    if (first_run)
    {
       var.key   = "stella2014_color_depth";
@@ -851,6 +867,25 @@ static void check_variables(bool first_run)
       if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
          if (strcmp(var.value, "24bit") == 0)
             framePixelBytes = 4;
+
+      var.key   = "stella2014_audio_rate";
+      var.value = NULL;
+
+      audio_rate = 31400;
+
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+         audio_rate = strtoul(var.value, NULL, 10);
+
+#ifdef STELLA_AUDIO_THREAD
+      var.key   = "stella2014_audio_thread";
+      var.value = NULL;
+
+      audio_thread = false;
+
+      if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+         if (strcmp(var.value, "enabled") == 0)
+            audio_thread = true;
+#endif
    }
 
    /* Read interframe blending option */
@@ -871,8 +906,47 @@ static void check_variables(bool first_run)
          blend_method = FRAME_BLEND_GHOST_95;
    }
 
+   /* Read scanline video conversion option */
+   var.key   = "stella2014_direct_video";
+   var.value = NULL;
+
+   direct_video_enabled = false;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      if (!strcmp(var.value, "enabled"))
+         direct_video_enabled = true;
+
    init_frame_blending(blend_method);
 
+   /* Read frameskip option */
+   var.key   = "stella2014_frameskip";
+   var.value = NULL;
+
+   frameskip_type     = FRAMESKIP_NONE;
+   frameskip_interval = 1;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (!strcmp(var.value, "fastforward"))
+         frameskip_type = FRAMESKIP_FASTFORWARD;
+      else if (strcmp(var.value, "disabled"))
+      {
+         /* Value is the number of frames skipped after each drawn one */
+         frameskip_type     = FRAMESKIP_FIXED;
+         frameskip_interval = strtoul(var.value, NULL, 10) + 1;
+      }
+   }
+
+   /* Read mid-frame input polling option */
+   var.key   = "stella2014_input_poll_lines";
+   var.value = NULL;
+
+   input_poll_lines = 0;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value &&
+       strcmp(var.value, "disabled"))
+      input_poll_lines = strtoul(var.value, NULL, 10);
+
    /* Read low pass audio filter settings */
    var.key   = "stella2014_low_pass_filter";
    var.value = NULL;
@@ -891,6 +965,9 @@ static void check_variables(bool first_run)
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
       low_pass_range = (strtol(var.value, NULL, 10) * 0x10000) / 100;
 
+   /* The filter is applied while the sound is generated */
+   osystem.sound().setLowPass(low_pass_enabled ? low_pass_range : 0);
+
    /* Read paddle digital sensitivity option */
    var.key   = "stella2014_paddle_digital_sensitivity";
    var.value = NULL;
@@ -1015,7 +1092,7 @@ void retro_get_system_av_info(struct retro_system_av_info *info)
 {
    memset(info, 0, sizeof(*info));
    info->timing.fps            = console->getFramerate();
-   info->timing.sample_rate    = 31400;
+   info->timing.sample_rate    = audio_rate;
    info->geometry.base_width   = 160 * 2;
    info->geometry.base_height  = videoHeight;
    info->geometry.max_width    = 320;
@@ -1197,12 +1274,15 @@ bool retro_load_game(const struct retro_game_info *info)
    // Init sound and video
    console->initializeVideo();
    console->initializeAudio();
+   osystem.sound().setOutputRate(audio_rate);
 
-   // Check number of audio channels
-   if (console->properties().get(Cartridge_Sound) == "STEREO")
-      apply_low_pass_filter = apply_low_pass_filter_stereo;
-   else
-      apply_low_pass_filter = apply_low_pass_filter_mono;
+   // Get the number of samples in a frame
+   audio_samples_per_frame = (uint32_t)((float)audio_rate/console->getFramerate());
+
+#ifdef STELLA_AUDIO_THREAD
+   if (audio_thread)
+      osystem.sound().startThread();
+#endif
 
    // Init paddle controls
    init_paddles();
@@ -1225,6 +1305,10 @@ bool retro_load_game_special(unsigned game_type, const struct retro_game_info *i
 
 void retro_unload_game(void) 
 {
+#ifdef STELLA_AUDIO_THREAD
+   osystem.sound().stopThread();
+#endif
+
    if (console)
    {
       delete console;
@@ -1286,6 +1370,9 @@ void retro_init(void)
    if (environ_cb(RETRO_ENVIRONMENT_GET_INPUT_BITMASKS, NULL))
       libretro_supports_bitmasks = true;
 
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &libretro_supports_dupe))
+      libretro_supports_dupe = false;
+
 #ifdef _3DS
    frameBuffer = (uint8_t*)linearMemAlign(FRAME_BUFFER_SIZE, 128);
 #else
@@ -1296,14 +1383,19 @@ void retro_init(void)
 void retro_deinit(void)
 {
    libretro_supports_bitmasks = false;
+   libretro_supports_dupe     = false;
+   frameskip_type             = FRAMESKIP_NONE;
+   frameskip_counter          = 0;
+   input_poll_lines           = 0;
    left_controller_type       = Controller::Joystick;
    MouseAxisValue0            = Event::MouseAxisXValue;
    MouseButtonValue0          = Event::MouseButtonLeftValue;
    MouseAxisValue1            = Event::MouseAxisYValue;
    MouseButtonValue1          = Event::MouseButtonRightValue;
+   audio_rate                 = 31400;
+   audio_samples_per_frame    = 0;
+   audio_thread               = false;
    low_pass_enabled           = false;
-   low_pass_left_prev         = 0;
-   low_pass_right_prev        = 0;
    currentPalette32           = NULL;
 
    if (frameBuffer)
@@ -1334,9 +1426,9 @@ void retro_reset(void)
 
 void retro_run(void)
 {
-   static int16_t sampleBuffer[2048];
-   //Get the number of samples in a frame
-   static uint32_t tiaSamplesPerFrame = (uint32_t)(31400.0f/console->getFramerate());
+   static int16_t sampleBuffer[4096];
+
+   PROFILE_SCOPE(Other);
 
    //CORE OPTIONS
    bool updated = false;
@@ -1347,26 +1439,71 @@ void retro_run(void)
    update_input();
 
    //EMULATE
+   //A skipped frame is fully emulated, only its pixels are not drawn
+   bool skipFrame = frameskip_check();
    TIA& tia = console->tia();
-   tia.update();
+   tia.enableRendering(!skipFrame);
+   if (direct_video)
+      tia.setDirectOutput(frameBuffer, tia.width() * framePixelBytes,
+            framePixelBytes, get_output_palette());
+   else
+      tia.setDirectOutput(NULL, 0, 0, NULL);
+   if (input_poll_lines)
+   {
+      //Run the frame in pieces, reading the input again after each; a
+      //frame still going past the tallest picture is left to update()
+      unsigned line = input_poll_lines;
+      bool done;
+      while (!(done = tia.updateToScanline(line)) && line < 320)
+      {
+         update_input();
+         line += input_poll_lines;
+      }
+      if (!done)
+         tia.update();
+   }
+   else
+      tia.update();
 
    //VIDEO
    //Get the frame info from stella
    videoWidth = tia.width();
    videoHeight = tia.height();
 
-   //Copy the frame from stella to libretro
-   if (framePixelBytes == 2)
-      blend_frames_16(tia.currentFrameBuffer(), videoWidth, videoHeight);
+   if (skipFrame)
+      //Repeat the last frame that was drawn
+      video_cb(libretro_supports_dupe ? NULL : frameBuffer,
+            videoWidth, videoHeight, videoWidth * framePixelBytes);
    else
-      blend_frames_32(tia.currentFrameBuffer(), videoWidth, videoHeight);
+   {
+      //Copy the frame from stella to libretro, unless it is already there
+      if (!direct_video)
+      {
+         PROFILE_SCOPE(Frontend);
+         if (framePixelBytes == 2)
+            blend_frames_16(tia.currentFrameBuffer(), videoWidth, videoHeight);
+         else
+            blend_frames_32(tia.currentFrameBuffer(), videoWidth, videoHeight);
+      }
 
-   video_cb(frameBuffer, videoWidth, videoHeight, videoWidth * framePixelBytes);
+      video_cb(frameBuffer, videoWidth, videoHeight, videoWidth * framePixelBytes);
+   }
 
-   osystem.sound().processFragment(sampleBuffer, tiaSamplesPerFrame);
+   //AUDIO
+   //The fragment comes back filtered and interleaved
+   osystem.sound().processFragment(sampleBuffer, audio_samples_per_frame);
 
-   if (low_pass_enabled)
-      apply_low_pass_filter(sampleBuffer, tiaSamplesPerFrame);
+   audio_batch_cb(sampleBuffer, audio_samples_per_frame);
 
-   audio_batch_cb(sampleBuffer, tiaSamplesPerFrame);
+#ifdef STELLA_PROFILE
+   Profiler::frameDone();
+   if (Profiler::frames() >= STELLA_PROFILE_INTERVAL)
+   {
+      char report[512];
+      Profiler::report(report, sizeof(report));
+      if (log_cb)
+         log_cb(RETRO_LOG_INFO, "[Stella]: profile: %s\n", report);
+      Profiler::reset();
+   }
+#endif
 }
@@ -75,6 +75,71 @@ struct retro_core_option_definition option_defs_us[] = {
       },
       "disabled"
    },
+   {
+      "stella2014_direct_video",
+      "Per-Scanline Video Conversion",
+      "Converts the picture to the output colors as each scanline is drawn, instead of the whole frame once it is done. The conversion is the same work either way, so this is not generally faster; it may help on systems where the pass over the finished frame misses the cache. Has no effect with Interframe Blending.",
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "stella2014_frameskip",
+      "Frameskip",
+      "Skips drawing frames to improve performance. Games still run exactly as without frameskip; only the picture is updated less often. 'Fast-Forward' draws one frame in four while the frontend is fast-forwarding. A number sets how many frames are skipped after each drawn one.",
+      {
+         { "disabled",    NULL },
+         { "fastforward", "Fast-Forward" },
+         { "1",           NULL },
+         { "2",           NULL },
+         { "3",           NULL },
+         { "4",           NULL },
+         { "5",           NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "stella2014_input_poll_lines",
+      "Mid-Frame Input Polling",
+      "Reads the controls again every given number of scanlines while a frame is emulated, instead of only before it, so that games can react to them sooner. Has no effect on games that read the controls once per frame at its start.",
+      {
+         { "disabled", NULL },
+         { "16",       "Every 16 scanlines" },
+         { "32",       "Every 32 scanlines" },
+         { "64",       "Every 64 scanlines" },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+   {
+      "stella2014_audio_rate",
+      "Audio Output Rate (Restart)",
+      "Sets the sample rate of the audio output. 'Native' outputs the 31400 Hz produced by the TIA. Higher rates are converted inside the core with a band-limited resampler, which avoids a second resampling pass in the frontend and the aliasing of the TIA's square waves.",
+      {
+         { "31400", "Native (31400 Hz)" },
+         { "44100", "44100 Hz" },
+         { "48000", "48000 Hz" },
+         { NULL, NULL },
+      },
+      "31400"
+   },
+#ifdef STELLA_AUDIO_THREAD
+   {
+      "stella2014_audio_thread",
+      "Audio Thread (Restart)",
+      "Generates and filters the sound on a separate thread while the next frame is emulated. Reduces the time spent per frame on multi-core systems, at the cost of one frame of extra audio latency.",
+      {
+         { "disabled", NULL },
+         { "enabled",  NULL },
+         { NULL, NULL },
+      },
+      "disabled"
+   },
+#endif
    {
       "stella2014_low_pass_filter",
       "Audio Filter",
@@ -0,0 +1,117 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef PROFILER_HXX
+#define PROFILER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Optional per-subsystem time breakdown of an emulated frame.
+
+  Only compiled in when STELLA_PROFILE is defined (make PROFILE=1).
+  Each instrumented subsystem opens a PROFILE_SCOPE; time is charged
+  exclusively to the innermost open scope, so e.g. TIA rendering that is
+  triggered from within a CPU write is not counted as CPU time.
+
+  The time source defaults to clock_gettime(CLOCK_MONOTONIC) in
+  nanoseconds.  Targets without it (or that prefer a cycle counter, such
+  as the Cortex-M DWT) can define STELLA_PROFILE_TICKS() to an expression
+  returning a monotonically increasing uInt32/uInt64 tick count, and
+  STELLA_PROFILE_TICKS_PER_US to its rate.
+*/
+#ifdef STELLA_PROFILE
+
+class Profiler
+{
+  public:
+    enum Section {
+      Other,     // everything not covered below (input, core glue)
+      CPU,       // M6502::execute
+      TIA,       // TIA::updateFrame
+      Sound,     // Sound::processFragment / TIASound::process
+      ARM,       // Thumbulator::run (DPC+ / CDF ARM code)
+      Frontend,  // frame blending
+      NumSections
+    };
+
+    /**
+      Start charging time to the given section, suspending the current one.
+    */
+    static void enter(Section section);
+
+    /**
+      Stop charging time to the innermost section and resume the previous.
+    */
+    static void leave();
+
+    /**
+      Mark the end of an emulated frame.
+    */
+    static void frameDone() { ++ourFrames; }
+
+    /**
+      Answers the number of frames accumulated since the last reset.
+    */
+    static uInt32 frames() { return ourFrames; }
+
+    /**
+      Clear all accumulated times.
+    */
+    static void reset();
+
+    /**
+      Format the accumulated times as average microseconds per frame.
+
+      @param buf   The buffer receiving the report
+      @param size  The size of the buffer
+    */
+    static void report(char* buf, uInt32 size);
+
+    /**
+      Get the name of the given section.
+    */
+    static const char* name(Section section);
+
+  private:
+    static uInt64 ourTicks[NumSections];
+    static uInt32 ourCalls[NumSections];
+    static Section ourStack[16];
+    static uInt32 ourDepth;
+    static uInt64 ourLast;
+    static uInt32 ourFrames;
+};
+
+/**
+  Opens a profiler section for the lifetime of the object.
+*/
+class ProfileScope
+{
+  public:
+    ProfileScope(Profiler::Section section) { Profiler::enter(section); }
+    ~ProfileScope() { Profiler::leave(); }
+};
+
+#define PROFILE_SCOPE(section) ProfileScope profileScope(Profiler::section)
+
+#else
+
+#define PROFILE_SCOPE(section)
+
+#endif
+
+#endif
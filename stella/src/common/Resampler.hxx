@@ -0,0 +1,121 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#ifndef RESAMPLER_HXX
+#define RESAMPLER_HXX
+
+#include "bspf.hxx"
+
+/**
+  Converts the stereo samples generated by TIASound at its native rate of
+  31400Hz to a higher output rate.
+
+  The TIA output only ever steps from one level to another, so instead of
+  interpolating between samples, every step is drawn into the output as a
+  band-limited step (a windowed sinc impulse that is integrated when the
+  output is read).  This produces no aliasing from the edges of the
+  square waves, and costs nothing while the output level doesn't change.
+  The output is delayed by kTaps / 2 samples.
+
+  Output rates of up to kMaxStep times the input rate are supported.
+*/
+class Resampler
+{
+  public:
+    enum {
+      kInputRate = 31400,   // The rate of the TIASound samples
+      kMaxOutput = 2048,    // Most output samples read at once
+      kMaxStep   = 4        // Highest ratio of output to input rate
+    };
+
+    /**
+      Create a new resampler for the given output rate, which is kept
+      between kInputRate and kInputRate * kMaxStep.
+    */
+    Resampler(uInt32 outputRate);
+
+    /**
+      Forget all samples seen so far.
+    */
+    void reset();
+
+    /**
+      Answers the output rate of the resampler.
+    */
+    uInt32 outputRate() const { return myOutputRate; }
+
+    /**
+      Answers how many input samples must be passed to resample() before
+      the given number of output samples can be read.
+
+      @param samples  The number of output samples (at most kMaxOutput)
+      @return  The number of input samples needed (at most kMaxOutput + 1)
+    */
+    uInt32 inputNeeded(uInt32 samples) const;
+
+    /**
+      Answers the buffer that the input samples for resample() are
+      generated into.
+    */
+    Int16* input() { return myInput; }
+
+    /**
+      Resample the samples at the start of the input buffer, and read the
+      next output samples.
+
+      @param length   The number of input samples, as given by inputNeeded()
+      @param output   The location to store the stereo output samples
+      @param samples  The number of output samples (at most kMaxOutput)
+    */
+    void resample(uInt32 length, Int16* output, uInt32 samples);
+
+  private:
+    enum {
+      kTaps       = 16, // Length of the band-limited step
+      kPhases     = 32, // Positions of a step between two output samples
+      kKernelBits = 14, // Fixed point bits of the kernel
+      kBufferSize = kMaxOutput + kTaps + kMaxStep
+    };
+
+    // The output rate, and how far each input sample advances the output
+    // (myStep + myStepFraction / kInputRate samples)
+    uInt32 myOutputRate;
+    uInt32 myStep;
+    uInt32 myStepFraction;
+
+    // The output sample the next input sample is drawn at, and the
+    // fraction of a sample past it (in units of 1 / kInputRate)
+    uInt32 myPosition;
+    uInt32 myFraction;
+
+    // The last input level and the integrated output of each channel
+    Int32 myLevel[2];
+    Int32 myOutput[2];
+
+    // The steps drawn so far, interleaved stereo; each output sample
+    // is the running sum of these
+    Int32 myBuffer[2 * kBufferSize];
+
+    // The stereo input samples
+    Int16 myInput[2 * (kMaxOutput + 1)];
+
+    // The band-limited step for each phase, each row adding up to
+    // 1 << kKernelBits
+    Int16 myKernel[kPhases][kTaps];
+};
+
+#endif
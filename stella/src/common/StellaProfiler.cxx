@@ -0,0 +1,130 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include "Profiler.hxx"
+
+#ifdef STELLA_PROFILE
+
+#include <cstdio>
+
+#ifndef STELLA_PROFILE_TICKS
+#include <time.h>
+
+static inline uInt64 profilerTicks()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uInt64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#define STELLA_PROFILE_TICKS() profilerTicks()
+#define STELLA_PROFILE_TICKS_PER_US 1000
+#endif
+
+// Sections nested deeper than the stack allows are charged to the
+// deepest tracked one
+#define PROFILE_MAX_DEPTH (sizeof(ourStack) / sizeof(ourStack[0]))
+#define PROFILE_TOP ourStack[(ourDepth < PROFILE_MAX_DEPTH ? ourDepth : PROFILE_MAX_DEPTH) - 1]
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::enter(Section section)
+{
+  uInt64 now = STELLA_PROFILE_TICKS();
+
+  if(ourDepth > 0)
+    ourTicks[PROFILE_TOP] += now - ourLast;
+  if(ourDepth < PROFILE_MAX_DEPTH)
+    ourStack[ourDepth] = section;
+  ourDepth++;
+
+  ourCalls[section]++;
+  ourLast = now;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::leave()
+{
+  uInt64 now = STELLA_PROFILE_TICKS();
+
+  if(ourDepth > 0)
+  {
+    ourTicks[PROFILE_TOP] += now - ourLast;
+    --ourDepth;
+  }
+
+  ourLast = now;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::reset()
+{
+  for(int i = 0; i < NumSections; ++i)
+  {
+    ourTicks[i] = 0;
+    ourCalls[i] = 0;
+  }
+  ourFrames = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Profiler::report(char* buf, uInt32 size)
+{
+  uInt64 total = 0;
+  uInt32 frames = ourFrames ? ourFrames : 1;
+  int len;
+
+  for(int i = 0; i < NumSections; ++i)
+    total += ourTicks[i];
+  if(total == 0)
+    total = 1;
+
+  len = snprintf(buf, size, "%u frames, %.1f us/frame:",
+                 ourFrames, (double)total / STELLA_PROFILE_TICKS_PER_US / frames);
+
+  for(int i = 0; i < NumSections && len > 0 && (uInt32)len < size; ++i)
+  {
+    len += snprintf(buf + len, size - len, " %s %.1f (%.1f%%, %u calls)",
+                    name((Section)i),
+                    (double)ourTicks[i] / STELLA_PROFILE_TICKS_PER_US / frames,
+                    100.0 * ourTicks[i] / total, ourCalls[i] / frames);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* Profiler::name(Section section)
+{
+  switch(section)
+  {
+    case Other:    return "other";
+    case CPU:      return "cpu";
+    case TIA:      return "tia";
+    case Sound:    return "sound";
+    case ARM:      return "arm";
+    case Frontend: return "frontend";
+    default:       return "?";
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 Profiler::ourTicks[Profiler::NumSections];
+uInt32 Profiler::ourCalls[Profiler::NumSections];
+Profiler::Section Profiler::ourStack[16];
+uInt32 Profiler::ourDepth = 0;
+uInt64 Profiler::ourLast = 0;
+uInt32 Profiler::ourFrames = 0;
+
+#endif
@@ -0,0 +1,139 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//============================================================================
+
+#include <cmath>
+#include <cstring>
+
+#include "Resampler.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Resampler::Resampler(uInt32 outputRate)
+{
+  if(outputRate < kInputRate)
+    outputRate = kInputRate;
+  else if(outputRate > kInputRate * kMaxStep)
+    outputRate = kInputRate * kMaxStep;
+
+  myOutputRate   = outputRate;
+  myStep         = outputRate / kInputRate;
+  myStepFraction = outputRate % kInputRate;
+
+  // Each phase is a Blackman windowed sinc, cut off a little below the
+  // output Nyquist frequency, centred between the middle two taps plus
+  // the distance of the step from the start of its output sample
+  const double pi = 3.14159265358979323846;
+  const double cutoff = 0.9;
+  for(uInt32 p = 0; p < kPhases; ++p)
+  {
+    double offset = (kTaps / 2 - 1) + (p + 0.5) / kPhases;
+    double taps[kTaps], sum = 0;
+    for(uInt32 t = 0; t < kTaps; ++t)
+    {
+      double x = t - offset;
+      double sinc = x == 0 ? 1 : sin(pi * cutoff * x) / (pi * cutoff * x);
+      double window = 0.42 + 0.5 * cos(2 * pi * x / kTaps) +
+                      0.08 * cos(4 * pi * x / kTaps);
+      taps[t] = sinc * window;
+      sum += taps[t];
+    }
+
+    // Every row must add up exactly, or the output would drift away
+    // from the input level; the rounding error goes to the largest tap
+    Int32 total = 0;
+    for(uInt32 t = 0; t < kTaps; ++t)
+    {
+      myKernel[p][t] = (Int16)floor(taps[t] * (1 << kKernelBits) / sum + 0.5);
+      total += myKernel[p][t];
+    }
+    myKernel[p][kTaps / 2 - 1 + (p >= kPhases / 2)] += (1 << kKernelBits) - total;
+  }
+
+  reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Resampler::reset()
+{
+  myPosition = myFraction = 0;
+  myLevel[0] = myLevel[1] = 0;
+  myOutput[0] = myOutput[1] = 0;
+  memset(myBuffer, 0, sizeof(myBuffer));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Resampler::inputNeeded(uInt32 samples) const
+{
+  // Input samples are needed until the next one would be drawn at or
+  // after the last output sample that is read
+  uInt32 start = myPosition * kInputRate + myFraction;
+  uInt32 end   = samples * kInputRate;
+
+  return end > start ? (end - start + myOutputRate - 1) / myOutputRate : 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Resampler::resample(uInt32 length, Int16* output, uInt32 samples)
+{
+  const Int16* input = myInput;
+  for(uInt32 i = 0; i < length; ++i, input += 2)
+  {
+    Int32 left  = input[0] - myLevel[0];
+    Int32 right = input[1] - myLevel[1];
+
+    // Nothing is drawn while the level stays the same, which is most of
+    // the time
+    if(left != 0 || right != 0)
+    {
+      const Int16* kernel = myKernel[myFraction * kPhases / kInputRate];
+      Int32* buffer = myBuffer + 2 * myPosition;
+      for(uInt32 t = 0; t < kTaps; ++t)
+      {
+        buffer[2 * t]     += kernel[t] * left;
+        buffer[2 * t + 1] += kernel[t] * right;
+      }
+      myLevel[0] = input[0];
+      myLevel[1] = input[1];
+    }
+
+    myPosition += myStep;
+    myFraction += myStepFraction;
+    if(myFraction >= kInputRate)
+    {
+      myFraction -= kInputRate;
+      ++myPosition;
+    }
+  }
+
+  for(uInt32 i = 0; i < 2 * samples; i += 2)
+  {
+    for(uInt32 c = 0; c < 2; ++c)
+    {
+      myOutput[c] += myBuffer[i + c];
+
+      Int32 sample = myOutput[c] >> kKernelBits;
+      if(sample > 32767)       sample = 32767;
+      else if(sample < -32768) sample = -32768;
+      output[i + c] = (Int16)sample;
+    }
+  }
+
+  // Move the steps that reach past the samples read to the front
+  uInt32 remaining = kBufferSize - samples;
+  memmove(myBuffer, myBuffer + 2 * samples, 2 * remaining * sizeof(Int32));
+  memset(myBuffer + 2 * remaining, 0, 2 * samples * sizeof(Int32));
+  myPosition -= samples;
+}
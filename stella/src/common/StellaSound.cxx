@@ -21,6 +21,7 @@
 #include <sstream>
 #endif
 #include <cmath>
+#include <cstring>
 
 #include "TIASnd.hxx"
 #include "FrameBuffer.hxx"
@@ -30,16 +31,28 @@
 #include "System.hxx"
 #include "OSystem.hxx"
 #include "Console.hxx"
+#include "Profiler.hxx"
+#include "Resampler.hxx"
 #include "Sound.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Sound::Sound(OSystem* osystem)
   : myIsEnabled(false),
     myIsInitializedFlag(false),
-    myLastRegisterSetCycle(0),
+    myCycleOffset(0),
+    myFragmentStartCycle(0),
     myNumChannels(0),
     myIsMuted(true),
-    myVolume(100)
+    myVolume(100),
+    myResampler(NULL)
+#ifdef STELLA_AUDIO_THREAD
+  , myThread(NULL),
+    myThreadFragment(NULL),
+    myThreadLength(0),
+    myThreadEnd(0),
+    myThreadBusy(false),
+    myThreadQuit(false)
+#endif
 {
   myIsInitializedFlag = true;
   myOSystem           = osystem;
@@ -48,8 +61,14 @@ Sound::Sound(OSystem* osystem)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Sound::~Sound()
 {
+#ifdef STELLA_AUDIO_THREAD
+  stopThread();
+#endif
+
   if(myIsInitializedFlag)
     myIsEnabled = myIsInitializedFlag = false;
+
+  delete myResampler;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -94,12 +113,15 @@ void Sound::open()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::close()
 {
+  synchronize();
   if(myIsInitializedFlag)
   {
     myIsEnabled = false;
-    myLastRegisterSetCycle = 0;
+    myCycleOffset = myFragmentStartCycle = 0;
     myTIASound.reset();
     myRegWriteQueue.clear();
+    if(myResampler)
+      myResampler->reset();
   }
 }
 
@@ -113,11 +135,14 @@ void Sound::mute(bool state)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::reset()
 {
+  synchronize();
   if(myIsInitializedFlag)
   {
-    myLastRegisterSetCycle = 0;
+    myCycleOffset = myFragmentStartCycle = 0;
     myTIASound.reset();
     myRegWriteQueue.clear();
+    if(myResampler)
+      myResampler->reset();
     mute(myIsMuted);
   }
 }
@@ -127,6 +152,7 @@ void Sound::setVolume(Int32 percent)
 {
   if(myIsInitializedFlag && (percent >= 0) && (percent <= 100))
   {
+    synchronize();
 #ifndef TARGET_GNW
     myOSystem->settings().setValue("volume", percent);
 #endif
@@ -135,6 +161,13 @@ void Sound::setVolume(Int32 percent)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::setLowPass(uInt32 factor)
+{
+  synchronize();
+  myTIASound.lowPass(factor);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::adjustVolume(Int8 direction)
 {
@@ -156,7 +189,7 @@ void Sound::adjustVolume(Int8 direction)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::adjustCycleCounter(Int32 amount)
 {
-  myLastRegisterSetCycle += amount;
+  myCycleOffset -= amount;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -171,161 +204,208 @@ void Sound::setFrameRate(float framerate)
 {
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::setOutputRate(uInt32 rate)
+{
+  if(myResampler && myResampler->outputRate() == rate)
+    return;
+
+  synchronize();
+  delete myResampler;
+  myResampler = rate > Resampler::kInputRate ? new Resampler(rate) : NULL;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::set(uInt16 addr, uInt8 value, Int32 cycle)
 {
-  // First, calculate how many seconds would have past since the last
-  // register write on a real 2600
-  double delta = (((double)(cycle - myLastRegisterSetCycle)) / 
-      (1193191.66666667));
-
-  // Now, adjust the time based on the frame rate the user has selected. For
-  // the sound to "scale" correctly, we have to know the games real frame 
-  // rate (e.g., 50 or 60) and the currently emulated frame rate. We use these
-  // values to "scale" the time before the register change occurs.
+  // The queue holds every write of a frame the TIA can show; only one
+  // running far past that (no VSYNC) makes the oldest write take effect
+  // early, once the sound thread has taken off those of the fragment it
+  // is generating
+  if(myRegWriteQueue.size() == RegWriteQueue::kCapacity)
+    synchronize();
+  if(myRegWriteQueue.size() == RegWriteQueue::kCapacity)
+  {
+    const RegWrite& info = myRegWriteQueue.front();
+    myTIASound.set(info.addr, info.value);
+    myRegWriteQueue.dequeue();
+  }
+
   RegWrite info;
   info.addr = addr;
   info.value = value;
-  info.delta = delta;
+  info.cycle = cycle + myCycleOffset;
   myRegWriteQueue.enqueue(info);
-
-  // Update last cycle counter to the current cycle
-  myLastRegisterSetCycle = cycle;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::processFragment(Int16* stream, uInt32 length)
 {
-    const uInt32 channels = 2;
-    double streamLengthInSecs = (double)length/(double)31400;
-    double excessStreamSecs = myRegWriteQueue.duration() - streamLengthInSecs;
-    if(excessStreamSecs > 0.0)
-    {
-        double removed = 0.0;
-        while(removed < excessStreamSecs)
-        {
-            RegWrite& info = myRegWriteQueue.front();
-            removed += info.delta;
-            myTIASound.set(info.addr, info.value);
-            myRegWriteQueue.dequeue();
-        }
-    }
+  PROFILE_SCOPE(Sound);
 
-  double position = 0.0;
-  double remaining = length;
+  uInt32 now = myOSystem->console().system().cycles() + myCycleOffset;
 
-  while(remaining > 0.0)
+#ifdef STELLA_AUDIO_THREAD
+  if(myThread)
   {
-    if(myRegWriteQueue.size() == 0)
-    {
-      // There are no more pending TIA sound register updates so we'll
-      // use the current settings to finish filling the sound fragment
-      myTIASound.process(stream + ((uInt32)position * channels),
-          length - (uInt32)position);
-
-      // Since we had to fill the fragment we'll reset the cycle counter
-      // to zero.  NOTE: This isn't 100% correct, however, it'll do for
-      // now.  We should really remember the overrun and remove it from
-      // the delta of the next write.
-      myLastRegisterSetCycle = 0;
-      break;
-    }
-    else
-    {
-      // There are pending TIA sound register updates so we need to
-      // update the sound buffer to the point of the next register update
-      RegWrite& info = myRegWriteQueue.front();
+    if(length > kMaxThreadFragment)
+      length = kMaxThreadFragment;
+
+    // Take the fragment generated for the previous call, and hand this
+    // one to the thread
+    synchronize();
+    memcpy(stream, myThreadFragment, 2 * length * sizeof(Int16));
+
+    std::lock_guard<std::mutex> lock(myThreadMutex);
+    myThreadLength = length;
+    myThreadEnd = now;
+    myThreadBusy = true;
+    myThreadCondition.notify_all();
+    return;
+  }
+#endif
 
-      // How long will the remaining samples in the fragment take to play
-      double duration = remaining / (double)31400;
+  generateFragment(stream, length, now);
+}
 
-      // Does the register update occur before the end of the fragment?
-      if(info.delta <= duration)
-      {
-        // If the register update time hasn't already passed then
-        // process samples upto the point where it should occur
-        if(info.delta > 0.0)
-        {
-          // Process the fragment upto the next TIA register write.  We
-          // round the count passed to process up if needed.
-          double samples = (31400 * info.delta);
-          myTIASound.process(stream + ((uInt32)position * channels),
-              (uInt32)samples + (uInt32)(position + samples) - 
-              ((uInt32)position + (uInt32)samples));
-
-          position += samples;
-          remaining -= samples;
-        }
-        myTIASound.set(info.addr, info.value);
-        myRegWriteQueue.dequeue();
-      }
-      else
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::generateFragment(Int16* stream, uInt32 length, uInt32 end)
+{
+  if(!myResampler)
+  {
+    renderFragment(stream, length, end);
+    return;
+  }
+
+  // The resampler takes a limited number of samples at once, so longer
+  // fragments are split, each part playing its share of the CPU cycles
+  const uInt32 channels = 2;
+  uInt32 start = myFragmentStartCycle, done = 0;
+  while(done < length)
+  {
+    uInt32 samples = length - done;
+    if(samples > Resampler::kMaxOutput)
+      samples = Resampler::kMaxOutput;
+
+    uInt32 part = start + (uInt32)((uInt64)(end - start) * (done + samples) / length);
+    uInt32 needed = myResampler->inputNeeded(samples);
+    renderFragment(myResampler->input(), needed, part);
+    myResampler->resample(needed, stream + done * channels, samples);
+    done += samples;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::renderFragment(Int16* stream, uInt32 length, uInt32 end)
+{
+  const uInt32 channels = 2;
+
+  // The samples play the CPU cycles emulated since the previous ones,
+  // and each register write takes effect as far into them as its cycle
+  // lies into those; after a long pause, writes older than
+  // kMaxFragmentCycles take effect at the start
+  uInt32 span = end - myFragmentStartCycle;
+  if(span > kMaxFragmentCycles)
+    span = kMaxFragmentCycles;
+  uInt32 start = end - span;
+
+  uInt32 position = 0;
+  while(myRegWriteQueue.size() > 0)
+  {
+    const RegWrite& info = myRegWriteQueue.front();
+
+    // Writes after the end are left for the next samples
+    Int32 offset = (Int32)(info.cycle - start);
+    if(offset > (Int32)span)
+      break;
+
+    if(offset > 0)
+    {
+      uInt32 sample = offset * length / span;
+      if(sample > position)
       {
-        // The next register update occurs in the next fragment so finish
-        // this fragment with the current TIA settings and reduce the register
-        // update delay by the corresponding amount of time
-        myTIASound.process(stream + ((uInt32)position * channels),
-            length - (uInt32)position);
-        info.delta -= duration;
-        break;
+        myTIASound.process(stream + position * channels, sample - position);
+        position = sample;
       }
     }
+    myTIASound.set(info.addr, info.value);
+    myRegWriteQueue.dequeue();
   }
-    
-//    double position = 0.0;
-//    double remaining = length;
-//    
-//    while(remaining > 0.0)
-//    {
-//        if(myRegWriteQueue.size() == 0)
-//        {
-//            // There are no more pending TIA sound register updates so we'll use the current settings to finish filling the sound fragment
-//            myTIASound.process(stream + ((uInt32)position * 2), length - (uInt32)position);
-//            myLastRegisterSetCycle = 0;
-//            break;
-//        }
-//        else
-//        {
-//            // There are pending TIA sound register updates so we need to
-//            // update the sound buffer to the point of the next register update
-//            RegWrite& info = myRegWriteQueue.front();
-//            
-//            // How long will the remaining samples in the fragment take to play
-//            //      double duration = remaining / (double)myHardwareSpec.freq;
-//            double duration = remaining / 31400.0;
-//            
-//            // Does the register update occur before the end of the fragment?
-//            if(info.delta <= duration)
-//            {
-//                // If the register update time hasn't already passed then
-//                // process samples upto the point where it should occur
-//                if(info.delta > 0.0)
-//                {
-//                    // Process the fragment upto the next TIA register write.  We
-//                    // round the count passed to process up if needed.
-//                    //          double samples = (myHardwareSpec.freq * info.delta);
-//                    double samples = (31400.0 * info.delta);
-//                    myTIASound.process(stream + ((uInt32)position * 2), (uInt32)samples + (uInt32)(position + samples) - ((uInt32)position + (uInt32)samples));
-//                    
-//                    position += samples;
-//                    remaining -= samples;
-//                }
-//                myTIASound.set(info.addr, info.value);
-//                myRegWriteQueue.dequeue();
-//            }
-//            else
-//            {
-//                // The next register update occurs in the next fragment so finish
-//                // this fragment with the current TIA settings and reduce the register
-//                // update delay by the corresponding amount of time
-//                myTIASound.process(stream + ((uInt32)position * 2), length - (uInt32)position);
-//                info.delta -= duration;
-//                break;
-//            }
-//        }
-//    }
+  myTIASound.process(stream + position * channels, length - position);
+
+  myFragmentStartCycle = end;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::synchronize() const
+{
+#ifdef STELLA_AUDIO_THREAD
+  if(myThread)
+  {
+    std::unique_lock<std::mutex> lock(myThreadMutex);
+    while(myThreadBusy)
+      myThreadCondition.wait(lock);
+  }
+#endif
+}
+
+#ifdef STELLA_AUDIO_THREAD
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::startThread()
+{
+  stopThread();
+
+  // The first fragment taken from the thread is silent
+  myThreadFragment = new Int16[2 * kMaxThreadFragment];
+  memset(myThreadFragment, 0, 2 * kMaxThreadFragment * sizeof(Int16));
+  myThreadBusy = myThreadQuit = false;
+  myThread = new std::thread(&Sound::threadMain, this);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::stopThread()
+{
+  if(!myThread)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(myThreadMutex);
+    myThreadQuit = true;
+    myThreadCondition.notify_all();
+  }
+  myThread->join();
+  delete myThread;
+  myThread = NULL;
+
+  delete[] myThreadFragment;
+  myThreadFragment = NULL;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Sound::threadMain()
+{
+  std::unique_lock<std::mutex> lock(myThreadMutex);
+  for(;;)
+  {
+    // A fragment handed over before stopping is still generated, so
+    // that no register writes are left behind
+    while(!myThreadBusy && !myThreadQuit)
+      myThreadCondition.wait(lock);
+    if(!myThreadBusy)
+      return;
+
+    uInt32 length = myThreadLength, end = myThreadEnd;
+    lock.unlock();
+
+    generateFragment(myThreadFragment, length, end);
+
+    lock.lock();
+    myThreadBusy = false;
+    myThreadCondition.notify_all();
+  }
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::callback(void* udata, uInt8* stream, int len)
 {
@@ -342,6 +422,7 @@ void Sound::callback(void* udata, uInt8* stream, int len)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Sound::save(Serializer& out) const
 {
+   synchronize();
    out.putString(name());
 
    uInt8 reg1 = 0, reg2 = 0, reg3 = 0, reg4 = 0, reg5 = 0, reg6 = 0;
@@ -364,7 +445,7 @@ bool Sound::save(Serializer& out) const
    out.putByte(reg5);
    out.putByte(reg6);
 
-   out.putInt(myLastRegisterSetCycle);
+   out.putInt(myFragmentStartCycle - myCycleOffset);
 
    return true;
 }
@@ -372,6 +453,7 @@ bool Sound::save(Serializer& out) const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Sound::load(Serializer& in)
 {
+   synchronize();
    if(in.getString() != name())
       return false;
 
@@ -382,7 +464,8 @@ bool Sound::load(Serializer& in)
          reg5 = in.getByte(),
          reg6 = in.getByte();
 
-   myLastRegisterSetCycle = (Int32) in.getInt();
+   myFragmentStartCycle = in.getInt();
+   myCycleOffset = 0;
 
    // Only update the TIA sound registers if sound is enabled
    // Make sure to empty the queue of previous sound fragments
@@ -401,85 +484,41 @@ bool Sound::load(Serializer& in)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Sound::RegWriteQueue::RegWriteQueue(uInt32 capacity)
-  : myCapacity(capacity),
-    myBuffer(0),
-    mySize(0),
-    myHead(0),
+Sound::RegWriteQueue::RegWriteQueue()
+  : myHead(0),
     myTail(0)
 {
-  myBuffer = new RegWrite[myCapacity];
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Sound::RegWriteQueue::~RegWriteQueue()
-{
-  delete[] myBuffer;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::RegWriteQueue::clear()
 {
-  myHead = myTail = mySize = 0;
+  myHead = 0;
+  myTail = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::RegWriteQueue::dequeue()
 {
-  if(mySize > 0)
-  {
-    myHead = (myHead + 1) % myCapacity;
-    --mySize;
-  }
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double Sound::RegWriteQueue::duration()
-{
-  double duration = 0.0;
-  for(uInt32 i = 0; i < mySize; ++i)
-  {
-    duration += myBuffer[(myHead + i) % myCapacity].delta;
-  }
-  return duration;
+  if(size() > 0)
+    ++myHead;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Sound::RegWriteQueue::enqueue(const RegWrite& info)
 {
-  // If an attempt is made to enqueue more than the queue can hold then
-  // we'll enlarge the queue's capacity.
-  if(mySize == myCapacity)
-    grow();
-
-  myBuffer[myTail] = info;
-  myTail = (myTail + 1) % myCapacity;
-  ++mySize;
+  myBuffer[myTail & (kCapacity - 1)] = info;
+  ++myTail;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Sound::RegWrite& Sound::RegWriteQueue::front()
+const Sound::RegWrite& Sound::RegWriteQueue::front() const
 {
-  return myBuffer[myHead];
+  return myBuffer[myHead & (kCapacity - 1)];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 Sound::RegWriteQueue::size() const
 {
-  return mySize;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void Sound::RegWriteQueue::grow()
-{
-  RegWrite* buffer = new RegWrite[myCapacity * 2];
-  for(uInt32 i = 0; i < mySize; ++i)
-  {
-    buffer[i] = myBuffer[(myHead + i) % myCapacity];
-  }
-  myHead = 0;
-  myTail = mySize;
-  myCapacity = myCapacity * 2;
-  delete[] myBuffer;
-  myBuffer = buffer;
+  return myTail - myHead;
 }
@@ -228,6 +228,31 @@ class Cartridge : public Device
     */
     void createCodeAccessBase(uInt32 size);
 
+#ifdef STELLA_FIXED_POINT
+    // Fraction of an OSC clock, in units of 1/143183 clock
+    typedef uInt32 MusicClockFraction;
+#else
+    typedef double MusicClockFraction;
+#endif
+
+    /**
+      Convert CPU cycles into clocks of the 20 kHz oscillator that drives
+      the music mode of DPC, DPC+ and CTY carts.  The part of a clock
+      that is left over is carried in 'fraction' to the next call.
+
+      @param cycles    The number of CPU cycles since the last call
+      @param fraction  The fraction of a clock carried between calls
+      @return  The number of whole OSC clocks
+    */
+    static Int32 musicClocks(Int32 cycles, MusicClockFraction& fraction);
+
+    /**
+      Convert a music clock fraction to and from the representation used
+      in state files (units of 1/100000000 clock).
+    */
+    static uInt32 saveMusicClockFraction(MusicClockFraction fraction);
+    static MusicClockFraction loadMusicClockFraction(uInt32 value);
+
   private:
     /**
       Get an image pointer and size for a ROM that is part of a larger,
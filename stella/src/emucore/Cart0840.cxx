@@ -155,7 +155,7 @@ bool Cartridge0840::bank(uInt16 bank)
   for(uInt32 address = 0x1000; address < 0x2000; address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -85,7 +85,7 @@ void Cartridge3E::install(System& system)
   for(uInt32 j = 0x1800; j < 0x2000; j += (1 << shift))
   {
     access.directPeekBase = &myImage[(mySize - 2048) + (j & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)]);
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -182,7 +182,7 @@ bool Cartridge3E::bank(uInt16 bank)
     for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
     {
       access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
+      access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x07FF)]);
       mySystem->setPageAccess(address >> shift, access);
     }
   }
@@ -203,7 +203,7 @@ bool Cartridge3E::bank(uInt16 bank)
     for(address = 0x1000; address < 0x1400; address += (1 << shift))
     {
       access.directPeekBase = &myRAM[offset + (address & 0x03FF)];
-      access.codeAccessBase = &myCodeAccessBase[mySize + offset + (address & 0x03FF)];
+      access.setCodeAccessBase(&myCodeAccessBase[mySize + offset + (address & 0x03FF)]);
       mySystem->setPageAccess(address >> shift, access);
     }
 
@@ -214,7 +214,7 @@ bool Cartridge3E::bank(uInt16 bank)
     for(address = 0x1400; address < 0x1800; address += (1 << shift))
     {
       access.directPokeBase = &myRAM[offset + (address & 0x03FF)];
-      access.codeAccessBase = &myCodeAccessBase[mySize + offset + (address & 0x03FF)];
+      access.setCodeAccessBase(&myCodeAccessBase[mySize + offset + (address & 0x03FF)]);
       mySystem->setPageAccess(address >> shift, access);
     }
   }
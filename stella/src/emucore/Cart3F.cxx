@@ -73,7 +73,7 @@ void Cartridge3F::install(System& system)
   for(uInt32 j = 0x1800; j < 0x2000; j += (1 << shift))
   {
     access.directPeekBase = &myImage[(mySize - 2048) + (j & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[(mySize - 2048) + (j & 0x07FF)]);
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -143,7 +143,7 @@ bool Cartridge3F::bank(uInt16 bank)
   for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x07FF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
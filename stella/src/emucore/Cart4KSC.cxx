@@ -64,7 +64,7 @@ void Cartridge4KSC::install(System& system)
   for(uInt32 j = 0x1000; j < 0x1080; j += (1 << shift))
   {
     access.directPokeBase = &myRAM[j & 0x007F];
-    access.codeAccessBase = &myCodeAccessBase[j & 0x007F];
+    access.setCodeAccessBase(&myCodeAccessBase[j & 0x007F]);
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -74,7 +74,7 @@ void Cartridge4KSC::install(System& system)
   for(uInt32 k = 0x1080; k < 0x1100; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[k & 0x007F];
-    access.codeAccessBase = &myCodeAccessBase[0x80 + (k & 0x007F)];
+    access.setCodeAccessBase(&myCodeAccessBase[0x80 + (k & 0x007F)]);
     mySystem->setPageAccess(k >> shift, access);
   }
 
@@ -82,7 +82,7 @@ void Cartridge4KSC::install(System& system)
   for(uInt32 address = 0x1100; address < 0x2000; address += (1 << shift))
   {
     access.directPeekBase = &myImage[address & 0x0FFF];
-    access.codeAccessBase = &myCodeAccessBase[address & 0x0FFF];
+    access.setCodeAccessBase(&myCodeAccessBase[address & 0x0FFF]);
     mySystem->setPageAccess(address >> mySystem->pageShift(), access);
   }
 }
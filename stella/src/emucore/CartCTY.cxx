@@ -35,7 +35,7 @@ CartridgeCTY::CartridgeCTY(const uInt8* image, uInt32 size, const OSystem& osyst
     myRandomNumber(0x2B435044),
     myRamAccessTimeout(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
   // Copy the ROM image into my buffer
   memcpy(myImage, image, MIN(32768u, size));
@@ -70,7 +70,7 @@ void CartridgeCTY::reset()
 
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -255,7 +255,7 @@ bool CartridgeCTY::bank(uInt16 bank)
   System::PageAccess access(0, 0, 0, this, System::PA_READ);
   for(uInt32 address = 0x1080; address < 0x2000; address += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[myCurrentBank + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[myCurrentBank + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -310,7 +310,7 @@ bool CartridgeCTY::save(Serializer& out) const
    out.putBool(myLDAimmediate);
    out.putInt(myRandomNumber);
    out.putInt(mySystemCycles);
-   out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+   out.putInt(saveMusicClockFraction(myFractionalClocks));
 
    return true;
 }
@@ -330,7 +330,7 @@ bool CartridgeCTY::load(Serializer& in)
    myLDAimmediate = in.getBool();
    myRandomNumber = in.getInt();
    mySystemCycles = (Int32)in.getInt();
-   myFractionalClocks = (double)in.getInt() / 100000000.0;
+   myFractionalClocks = loadMusicClockFraction(in.getInt());
 
    return true;
 }
@@ -514,9 +514,7 @@ inline void CartridgeCTY::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  Int32 wholeClocks = musicClocks(cycles, myFractionalClocks);
 
   if(wholeClocks <= 0)
     return;
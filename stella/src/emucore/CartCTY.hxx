@@ -296,7 +296,7 @@ class CartridgeCTY : public Cartridge
     Int32 mySystemCycles;
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    MusicClockFraction myFractionalClocks;
 };
 
 #endif
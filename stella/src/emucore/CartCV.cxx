@@ -91,13 +91,13 @@ void CartridgeCV::install(System& system)
   for(uInt32 address = 0x1800; address < 0x2000; address += (1 << shift))
   {
     access.directPeekBase = &myImage[address & 0x07FF];
-    access.codeAccessBase = &myCodeAccessBase[address & 0x07FF];
+    access.setCodeAccessBase(&myCodeAccessBase[address & 0x07FF]);
     mySystem->setPageAccess(address >> mySystem->pageShift(), access);
   }
 
   // Set the page accessing method for the RAM writing pages
   access.directPeekBase = 0;
-  access.codeAccessBase = 0;
+  access.setCodeAccessBase(0);
   access.type = System::PA_WRITE;
   for(uInt32 j = 0x1400; j < 0x1800; j += (1 << shift))
   {
@@ -111,7 +111,7 @@ void CartridgeCV::install(System& system)
   for(uInt32 k = 0x1000; k < 0x1400; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[k & 0x03FF];
-    access.codeAccessBase = &myCodeAccessBase[2048 + (k & 0x03FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[2048 + (k & 0x03FF)]);
     mySystem->setPageAccess(k >> shift, access);
   }
 }
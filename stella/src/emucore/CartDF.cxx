@@ -95,7 +95,7 @@ bool CartridgeDF::bank(uInt16 bank)
   // Set the page accessing methods for the hot spots
   for(uInt32 i = (0x1FC0 & ~mask); i < 0x2000; i += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (i & 0x0FFF)]);
     mySystem->setPageAccess(i >> shift, access);
   }
 
@@ -104,7 +104,7 @@ bool CartridgeDF::bank(uInt16 bank)
       address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
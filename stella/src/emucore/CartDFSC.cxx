@@ -69,7 +69,7 @@ void CartridgeDFSC::install(System& system)
   for(uInt32 j = 0x1000; j < 0x1080; j += (1 << shift))
   {
     access.directPokeBase = &myRAM[j & 0x007F];
-    access.codeAccessBase = &myCodeAccessBase[j & 0x007F];
+    access.setCodeAccessBase(&myCodeAccessBase[j & 0x007F]);
     mySystem->setPageAccess(j >> shift, access);
   }
  
@@ -79,7 +79,7 @@ void CartridgeDFSC::install(System& system)
   for(uInt32 k = 0x1080; k < 0x1100; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[k & 0x007F];
-    access.codeAccessBase = &myCodeAccessBase[0x80 + (k & 0x007F)];
+    access.setCodeAccessBase(&myCodeAccessBase[0x80 + (k & 0x007F)]);
     mySystem->setPageAccess(k >> shift, access);
   }
 
@@ -145,7 +145,7 @@ bool CartridgeDFSC::bank(uInt16 bank)
   // Set the page accessing methods for the hot spots
   for(uInt32 i = (0x1FC0 & ~mask); i < 0x2000; i += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (i & 0x0FFF)]);
     mySystem->setPageAccess(i >> shift, access);
   }
 
@@ -154,7 +154,7 @@ bool CartridgeDFSC::bank(uInt16 bank)
       address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
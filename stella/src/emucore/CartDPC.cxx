@@ -28,7 +28,7 @@ CartridgeDPC::CartridgeDPC(const uInt8* image, uInt32 size,
   : Cartridge(settings),
     mySize(size),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
   // Make a copy of the entire image
   memcpy(myImage, image, MIN(size, 8192u + 2048u + 256u));
@@ -64,7 +64,7 @@ void CartridgeDPC::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -122,9 +122,7 @@ inline void CartridgeDPC::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  Int32 wholeClocks = musicClocks(cycles, myFractionalClocks);
 
   if(wholeClocks <= 0)
   {
@@ -418,7 +416,7 @@ bool CartridgeDPC::bank(uInt16 bank)
   // Set the page accessing methods for the hot spots
   for(uInt32 i = (0x1FF8 & ~mask); i < 0x2000; i += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (i & 0x0FFF)]);
     mySystem->setPageAccess(i >> shift, access);
   }
 
@@ -427,7 +425,7 @@ bool CartridgeDPC::bank(uInt16 bank)
       address += (1 << shift))
   {
     access.directPeekBase = &myProgramImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -495,7 +493,7 @@ bool CartridgeDPC::save(Serializer& out) const
    out.putByte(myRandomNumber);
 
    out.putInt(mySystemCycles);
-   out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+   out.putInt(saveMusicClockFraction(myFractionalClocks));
 
    return true;
 }
@@ -530,7 +528,7 @@ bool CartridgeDPC::load(Serializer& in)
 
    // Get system cycles and fractional clocks
    mySystemCycles = (Int32)in.getInt();
-   myFractionalClocks = (double)in.getInt() / 100000000.0;
+   myFractionalClocks = loadMusicClockFraction(in.getInt());
 
    // Now, go to the current bank
    bank(myCurrentBank);
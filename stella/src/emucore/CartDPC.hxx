@@ -201,7 +201,7 @@ class CartridgeDPC : public Cartridge
     Int32 mySystemCycles;
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    MusicClockFraction myFractionalClocks;
 };
 
 #endif
@@ -31,7 +31,7 @@ CartridgeDPCPlus::CartridgeDPCPlus(const uInt8* image, uInt32 size,
     myLDAimmediate(false),
     myParameterPointer(0),
     mySystemCycles(0),
-    myFractionalClocks(0.0)
+    myFractionalClocks(0)
 {
   // Store image, making sure it's at least 29KB
   uInt32 minsize = 4096 * 6 + 4096 + 1024 + 255;
@@ -81,7 +81,7 @@ void CartridgeDPCPlus::reset()
 {
   // Update cycles to the current system cycles
   mySystemCycles = mySystem->cycles();
-  myFractionalClocks = 0.0;
+  myFractionalClocks = 0;
 
   setInitialState();
 
@@ -161,9 +161,7 @@ inline void CartridgeDPCPlus::updateMusicModeDataFetchers()
   mySystemCycles = mySystem->cycles();
 
   // Calculate the number of DPC OSC clocks since the last update
-  double clocks = ((20000.0 * cycles) / 1193191.66666667) + myFractionalClocks;
-  Int32 wholeClocks = (Int32)clocks;
-  myFractionalClocks = clocks - (double)wholeClocks;
+  Int32 wholeClocks = musicClocks(cycles, myFractionalClocks);
 
   if(wholeClocks <= 0)
   {
@@ -599,7 +597,7 @@ bool CartridgeDPCPlus::bank(uInt16 bank)
   // Map Program ROM image into the system
   for(uInt32 address = 0x1080; address < 0x2000; address += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -685,7 +683,7 @@ bool CartridgeDPCPlus::save(Serializer& out) const
    out.putInt(myRandomNumber);
 
    out.putInt(mySystemCycles);
-   out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+   out.putInt(saveMusicClockFraction(myFractionalClocks));
 
    return true;
 }
@@ -738,7 +736,7 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
    // Get system cycles and fractional clocks
    mySystemCycles = (Int32)in.getInt();
-   myFractionalClocks = (double)in.getInt() / 100000000.0;
+   myFractionalClocks = loadMusicClockFraction(in.getInt());
 
    // Now, go to the current bank
    bank(myCurrentBank);
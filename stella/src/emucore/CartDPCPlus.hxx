@@ -249,7 +249,7 @@ class CartridgeDPCPlus : public Cartridge
     Int32 mySystemCycles;
 
     // Fractional DPC music OSC clocks unused during the last update
-    double myFractionalClocks;
+    MusicClockFraction myFractionalClocks;
 };
 
 #endif
@@ -60,14 +60,14 @@ void CartridgeE0::install(System& system)
   for(uInt32 i = 0x1C00; i < (0x1FE0U & ~mask); i += (1 << shift))
   {
     access.directPeekBase = &myImage[7168 + (i & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[7168 + (i & 0x03FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[7168 + (i & 0x03FF)]);
     mySystem->setPageAccess(i >> shift, access);
   }
   myCurrentSlice[3] = 7;
 
   // Set the page accessing methods for the hot spots in the last segment
   access.directPeekBase = 0;
-  access.codeAccessBase = &myCodeAccessBase[8128];
+  access.setCodeAccessBase(&myCodeAccessBase[8128]);
   access.type = System::PA_READ;
   for(uInt32 j = (0x1FE0 & ~mask); j < 0x2000; j += (1 << shift))
     mySystem->setPageAccess(j >> shift, access);
@@ -137,7 +137,7 @@ void CartridgeE0::segmentZero(uInt16 slice)
   for(uInt32 address = 0x1000; address < 0x1400; address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x03FF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   myBankChanged = true;
@@ -159,7 +159,7 @@ void CartridgeE0::segmentOne(uInt16 slice)
   for(uInt32 address = 0x1400; address < 0x1800; address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x03FF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   myBankChanged = true;
@@ -181,7 +181,7 @@ void CartridgeE0::segmentTwo(uInt16 slice)
   for(uInt32 address = 0x1800; address < 0x1C00; address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x03FF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   myBankChanged = true;
@@ -75,7 +75,7 @@ void CartridgeE7::install(System& system)
   // Set the page accessing methods for the hot spots
   for(uInt32 i = (0x1FE0 & ~mask); i < 0x2000; i += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[8128];
+    access.setCodeAccessBase(&myCodeAccessBase[8128]);
     mySystem->setPageAccess(i >> shift, access);
   }
 
@@ -83,7 +83,7 @@ void CartridgeE7::install(System& system)
   for(uInt32 j = 0x1A00; j < (0x1FE0U & ~mask); j += (1 << shift))
   {
     access.directPeekBase = &myImage[7 * 2048 + (j & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[7 * 2048 + (j & 0x07FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[7 * 2048 + (j & 0x07FF)]);
     mySystem->setPageAccess(j >> shift, access);
   }
   myCurrentSlice[1] = 7;
@@ -177,7 +177,7 @@ void CartridgeE7::bankRAM(uInt16 bank)
   for(uInt32 j = 0x1800; j < 0x1900; j += (1 << shift))
   {
     access.directPokeBase = &myRAM[1024 + offset + (j & 0x00FF)];
-    access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + (j & 0x00FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[8192 + 1024 + offset + (j & 0x00FF)]);
     mySystem->setPageAccess(j >> shift, access);
   }
 
@@ -187,7 +187,7 @@ void CartridgeE7::bankRAM(uInt16 bank)
   for(uInt32 k = 0x1900; k < 0x1A00; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[1024 + offset + (k & 0x00FF)];
-    access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + (k & 0x00FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[8192 + 1024 + offset + (k & 0x00FF)]);
     mySystem->setPageAccess(k >> shift, access);
   }
   myBankChanged = true;
@@ -212,7 +212,7 @@ bool CartridgeE7::bank(uInt16 slice)
     for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
     {
       access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
+      access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x07FF)]);
       mySystem->setPageAccess(address >> shift, access);
     }
   }
@@ -224,7 +224,7 @@ bool CartridgeE7::bank(uInt16 slice)
     for(uInt32 j = 0x1000; j < 0x1400; j += (1 << shift))
     {
       access.directPokeBase = &myRAM[j & 0x03FF];
-      access.codeAccessBase = &myCodeAccessBase[8192 + (j & 0x03FF)];
+      access.setCodeAccessBase(&myCodeAccessBase[8192 + (j & 0x03FF)]);
       mySystem->setPageAccess(j >> shift, access);
     }
 
@@ -234,7 +234,7 @@ bool CartridgeE7::bank(uInt16 slice)
     for(uInt32 k = 0x1400; k < 0x1800; k += (1 << shift))
     {
       access.directPeekBase = &myRAM[k & 0x03FF];
-      access.codeAccessBase = &myCodeAccessBase[8192 + (k & 0x03FF)];
+      access.setCodeAccessBase(&myCodeAccessBase[8192 + (k & 0x03FF)]);
       mySystem->setPageAccess(k >> shift, access);
     }
   }
@@ -69,7 +69,7 @@ void CartridgeFA::install(System& system)
   for(uInt32 j = 0x1000; j < 0x1100; j += (1 << shift))
   {
     access.directPokeBase = &myRAM[j & 0x00FF];
-    access.codeAccessBase = &myCodeAccessBase[j & 0x00FF];
+    access.setCodeAccessBase(&myCodeAccessBase[j & 0x00FF]);
     mySystem->setPageAccess(j >> shift, access);
   }
  
@@ -79,7 +79,7 @@ void CartridgeFA::install(System& system)
   for(uInt32 k = 0x1100; k < 0x1200; k += (1 << shift))
   {
     access.directPeekBase = &myRAM[k & 0x00FF];
-    access.codeAccessBase = &myCodeAccessBase[0x100 + (k & 0x00FF)];
+    access.setCodeAccessBase(&myCodeAccessBase[0x100 + (k & 0x00FF)]);
     mySystem->setPageAccess(k >> shift, access);
   }
 
@@ -181,7 +181,7 @@ bool CartridgeFA::bank(uInt16 bank)
   // Set the page accessing methods for the hot spots
   for(uInt32 i = (0x1FF8 & ~mask); i < 0x2000; i += (1 << shift))
   {
-    access.codeAccessBase = &myCodeAccessBase[offset + (i & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (i & 0x0FFF)]);
     mySystem->setPageAccess(i >> shift, access);
   }
 
@@ -190,7 +190,7 @@ bool CartridgeFA::bank(uInt16 bank)
       address += (1 << shift))
   {
     access.directPeekBase = &myImage[offset + (address & 0x0FFF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+    access.setCodeAccessBase(&myCodeAccessBase[offset + (address & 0x0FFF)]);
     mySystem->setPageAccess(address >> shift, access);
   }
   return myBankChanged = true;
@@ -101,9 +101,11 @@ class M6502 : public Serializable
       true iff execution stops normally.
 
       @param number Indicates the number of instructions to execute
+      @param cycleLimit Stop after the first instruction ending at or past
+                        this system cycle
       @return true iff execution stops normally
     */
-    bool execute(uInt32 number);
+    bool execute(uInt32 number, uInt32 cycleLimit = 0xffffffff);
 
     /**
       Tell the processor to stop executing instructions.  Invoking this 
@@ -138,7 +140,8 @@ class M6502 : public Serializable
       Return the last address that was part of a read/peek.  Note that
       reads which are part of a write are not considered here, unless
       they're not the same as the last write address.  This eliminates
-      accesses that are part of a normal read/write cycle.
+      accesses that are part of a normal read/write cycle.  Only kept
+      when built with DEBUGGER_SUPPORT.
 
       @return The address of the last read
     */
@@ -170,7 +173,8 @@ class M6502 : public Serializable
     Int32 lastSrcAddressY() const { return myLastSrcAddressY; }
 
     /**
-      Get the total number of instructions executed so far.
+      Get the total number of instructions executed so far.  Only
+      counted when built with DEBUGGER_SUPPORT.
 
       @return The number of executed instructions
     */
@@ -264,11 +268,75 @@ class M6502 : public Serializable
       C = ps & 0x01;
     }
 
+    /**
+      The instruction loop of execute(), which only checks the cycle
+      limit when CycleLimit is set
+
+      @param number Indicates the number of instructions to execute
+      @return true iff execution stops normally
+    */
+    template<bool CycleLimit>
+    bool executeInstructions(uInt32 number);
+
     /**
       Called after an interrupt has be requested using irq() or nmi()
     */
     void interruptHandler();
 
+    /**
+      Called when a branch has jumped back to the instruction before it.
+      If the two instructions only poll the RIOT timer (such as
+      'wait: LDA INTIM / BNE wait'), runs the iterations of the loop that
+      would not leave it by advancing the system cycles, as they would
+      neither change the machine nor be seen by the TIA.
+
+      @param number The number of instructions left to execute, counting
+                    the branch
+      @return  The number of instructions skipped
+    */
+    uInt32 skipTimerLoop(uInt32 number);
+
+#ifdef M6502_BLOCK_CACHE
+    /**
+      An instruction decoded in advance, with its code bytes
+    */
+    struct DecodedInstruction
+    {
+      uInt8 code[3];  // The opcode and operand bytes
+      uInt8 length;   // The number of code bytes
+    };
+
+    /**
+      A run of instructions decoded from the code read through one page,
+      going on past the branches but ending with the first jump, call or
+      return.  It is kept for the address it starts at, and is used while
+      the generation of its page stays what it was when the block was
+      last checked against the code there.
+    */
+    struct DecodedBlock
+    {
+      const uInt8* code;   // Where the code is in memory
+      uInt32 generation;   // The generation of the page when checked
+      uInt16 address;      // The address of the first instruction
+      uInt8 count;         // The number of instructions
+      uInt8 rewrites;      // The times its code was found rewritten
+      DecodedInstruction instruction[16];
+    };
+
+    /**
+      Answer the decoded block for the code at the given address when the
+      block kept for it is not known to hold that code: the block is
+      checked against the code, and decoded again if the code differs.
+      It holds no instructions when the code isn't read directly or keeps
+      being rewritten, or the first instruction crosses the page or jams
+      the processor.
+
+      @param address The address of the first instruction
+      @return  The block
+    */
+    const DecodedBlock* decodedBlock(uInt16 address);
+#endif
+
   private:
     uInt8 A;    // Accumulator
     uInt8 X;    // X index register
@@ -298,6 +366,14 @@ class M6502 : public Serializable
       NonmaskableInterruptBit = 0x08
     };
     uInt8 myExecutionStatus;
+
+    /// The system cycle execute() has been asked to stop at
+    uInt32 myCycleLimit;
+
+#ifdef M6502_BLOCK_CACHE
+    /// The decoded blocks, found by the address they start at
+    DecodedBlock* myDecodedBlocks;
+#endif
   
     /// Pointer to the system the processor is installed in or the null pointer
     System* mySystem;
@@ -344,6 +420,23 @@ class M6502 : public Serializable
       cycles will be added during the execution of an instruction.
     */
     static uInt32 ourInstructionCycleTable[256];
+
+#ifdef M6502_BLOCK_CACHE
+    /**
+      Table of the number of code bytes each instruction reads before
+      any other access (just the opcode for BRK and JSR), with 0x80 set
+      for the jumps, calls and returns (ending a decoded block), and 0
+      for those that jam the processor
+    */
+    static const uInt8 ourInstructionLengthTable[256];
+
+    /// The number of decoded blocks kept
+    static const uInt32 ourDecodedBlockCount = 4096;
+
+    /// The times the code of a block may be rewritten before it is no
+    /// longer decoded
+    static const uInt8 ourBlockRewriteLimit = 3;
+#endif
 };
 
 #endif
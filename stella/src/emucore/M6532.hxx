@@ -139,9 +139,36 @@ class M6532 : public Device
     */
     bool poke(uInt16 address, uInt8 value);
 
+    /**
+      Read INTIM or TIMINT as if at the given system cycle, with the same
+      side effects as peek().  Used by the CPU to account for the reads
+      of a timer polling loop it skips.
+
+      @param address The address of the timer register
+      @param cycle The system cycle of the read
+
+      @return  The value of the timer register
+    */
+    uInt8 peekTimer(uInt16 address, uInt32 cycle);
+
+    /**
+      Get the value INTIM or TIMINT would answer if read at the given
+      system cycle, without changing the state of the system, and the
+      first cycle after it at which the answer may be different.
+
+      @param address The address of the timer register
+      @param cycle The system cycle of the read
+      @param until Set to the first cycle the answer may change at
+
+      @return  The value of the timer register
+    */
+    uInt8 timerValue(uInt16 address, uInt32 cycle, uInt32& until) const;
+
   private:
     Int32 timerClocks() const
-      { return myTimer - (mySystem->cycles() - myCyclesWhenTimerSet); }
+      { return timerClocks(mySystem->cycles()); }
+    Int32 timerClocks(uInt32 cycle) const
+      { return myTimer - (cycle - myCyclesWhenTimerSet); }
 
     void setTimerRegister(uInt8 data, uInt8 interval);
     void setPinState(bool shcha);
@@ -265,14 +265,22 @@ void Paddles::update()
   int sa_yaxis = myEvent.get(myP1AxisValue);
   if(abs(myLastAxisX - sa_xaxis) > 10)
   {
+#ifdef STELLA_FIXED_POINT
+    myAnalogPinValue[Nine] = (32767 - (Int16)sa_xaxis) * 21875 / 1024;
+#else
     myAnalogPinValue[Nine] = (Int32)(1400000 *
         (float)(32767 - (Int16)sa_xaxis) / 65536.0);
+#endif
     sa_changed = true;
   }
   if(abs(myLastAxisY - sa_yaxis) > 10)
   {
+#ifdef STELLA_FIXED_POINT
+    myAnalogPinValue[Five] = (32767 - (Int16)sa_yaxis) * 21875 / 1024;
+#else
     myAnalogPinValue[Five] = (Int32)(1400000 *
         (float)(32767 - (Int16)sa_yaxis) / 65536.0);
+#endif
     sa_changed = true;
   }
   myLastAxisX = sa_xaxis;
@@ -368,12 +376,20 @@ void Paddles::update()
   }
 
   // Only change state if the charge has actually changed
+  // (1400000 / TRIGRANGE is 21875 / 64)
+#ifdef STELLA_FIXED_POINT
+  if(myCharge[1] != myLastCharge[1])
+    myAnalogPinValue[Five] = myCharge[1] * 21875 / 64;
+  if(myCharge[0] != myLastCharge[0])
+    myAnalogPinValue[Nine] = myCharge[0] * 21875 / 64;
+#else
   if(myCharge[1] != myLastCharge[1])
     myAnalogPinValue[Five] =
         (Int32)(1400000 * (myCharge[1] / float(TRIGRANGE)));
   if(myCharge[0] != myLastCharge[0])
     myAnalogPinValue[Nine] =
         (Int32)(1400000 * (myCharge[0] / float(TRIGRANGE)));
+#endif
 
   myLastCharge[1] = myCharge[1];
   myLastCharge[0] = myCharge[0];
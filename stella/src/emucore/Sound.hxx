@@ -21,11 +21,19 @@
 #define SOUND_HXX
 
 class OSystem;
+class Resampler;
 
 #include "Serializable.hxx"
 #include "bspf.hxx"
 #include "TIASnd.hxx"
 
+#ifdef STELLA_AUDIO_THREAD
+  #include <atomic>
+  #include <condition_variable>
+  #include <mutex>
+  #include <thread>
+#endif
+
 /**
   This class is an abstract base class for the various sound objects.
   It has no functionality whatsoever.
@@ -77,6 +85,15 @@ class Sound : public Serializable
     */
     void setFrameRate(float framerate);
 
+    /**
+      Sets the rate of the samples returned by processFragment.  Sound is
+      always generated at the TIA rate of 31400Hz, and resampled to any
+      other (higher) rate.
+
+      @param rate The output rate in Hz
+    */
+    void setOutputRate(uInt32 rate);
+
     /**
       Start the sound system, initializing it if necessary.  This must be
       called before any calls are made to derived methods.
@@ -136,10 +153,42 @@ class Sound : public Serializable
       the TIASnd class always generates signed 16-bit stereo samples.
 
       @param stream  Pointer to the start of the fragment
-      @param length  Length of the fragment
+      @param length  Length of the fragment (less than 65536 samples)
     */
     void processFragment(Int16* stream, uInt32 length);
 
+    /**
+      Sets the single-pole low-pass filter applied to the sound as it
+      is generated, at the TIA rate.
+
+      @param factor  The filter factor in 16.16 fixed point (0 for none)
+    */
+    void setLowPass(uInt32 factor);
+
+#ifdef STELLA_AUDIO_THREAD
+    /**
+      Generate the sound fragments on a thread of their own, while the
+      emulation goes on.  From now on processFragment hands the fragment
+      it is called for to the thread, and returns the one generated for
+      the previous call (which must have asked for the same length, of
+      at most 4096 samples).
+    */
+    void startThread();
+
+    /**
+      Stop the sound thread, and generate the fragments in
+      processFragment again.
+    */
+    void stopThread();
+#endif
+
+    /**
+      Wait until the sound thread (if any) has generated the fragment
+      handed to it last.  Until the next call to processFragment, the
+      sound state can then be changed safely.
+    */
+    void synchronize() const;
+
     /**
       Saves the current state of this device to the given Serializer.
 
@@ -172,27 +221,33 @@ class Sound : public Serializable
     {
       uInt16 addr;
       uInt8 value;
-      double delta;
+      uInt32 cycle;
     };
 
     /**
-      A queue class used to hold TIA sound register writes before being
-      processed while creating a sound fragment.
+      A fixed-size ring buffer used to hold TIA sound register writes
+      before being processed while creating a sound fragment.
     */
     class RegWriteQueue
     {
       public:
-        /**
-          Create a new queue instance with the specified initial
-          capacity.  If the queue ever reaches its capacity then it will
-          automatically increase its size.
-        */
-        RegWriteQueue(uInt32 capacity = 512);
+        // Number of writes the queue holds; a power of two.  A frame of
+        // up to 320 scanlines writes at most once per 3 CPU cycles, 8107
+        // times, and with the sound thread the queue holds the writes of
+        // two frames
+#ifdef STELLA_AUDIO_THREAD
+        enum { kCapacity = 16384 };
+#else
+        enum { kCapacity = 8192 };
+#endif
+
+        // Writes are added by the emulation and, with the sound thread,
+        // taken off by it; neither end needs a lock
 
         /**
-          Destroy this queue instance.
+          Create a new, empty queue instance.
         */
-        virtual ~RegWriteQueue();
+        RegWriteQueue();
 
         /**
           Clear any items stored in the queue.
@@ -205,12 +260,7 @@ class Sound : public Serializable
         void dequeue();
 
         /**
-          Return the duration of all the items in the queue.
-        */
-        double duration();
-
-        /**
-          Enqueue the specified object.
+          Enqueue the specified object.  The queue must not be full.
         */
         void enqueue(const RegWrite& info);
 
@@ -219,7 +269,7 @@ class Sound : public Serializable
 
           @return  The item at the front of the queue.
         */
-        RegWrite& front();
+        const RegWrite& front() const;
 
         /**
           Answers the number of items currently in the queue.
@@ -229,16 +279,44 @@ class Sound : public Serializable
         uInt32 size() const;
 
       private:
-        // Increase the size of the queue
-        void grow();
+        RegWrite myBuffer[kCapacity];
 
-        uInt32 myCapacity;
-        RegWrite* myBuffer;
-        uInt32 mySize;
+        // Running counts of the writes taken off and added
+#ifdef STELLA_AUDIO_THREAD
+        std::atomic<uInt32> myHead;
+        std::atomic<uInt32> myTail;
+#else
         uInt32 myHead;
         uInt32 myTail;
+#endif
     };
 
+  private:
+    /**
+      Generate TIA samples for the CPU cycles up to the given one,
+      applying the queued register writes stamped before it.
+
+      @param stream  Pointer to the start of the samples
+      @param length  Number of samples
+      @param end     Stamp of the cycle the samples end at
+    */
+    void renderFragment(Int16* stream, uInt32 length, uInt32 end);
+
+    /**
+      Generate a sound fragment at the output rate, for the CPU cycles
+      up to the given one.
+
+      @param stream  Pointer to the start of the fragment
+      @param length  Length of the fragment
+      @param end     Stamp of the cycle the fragment ends at
+    */
+    void generateFragment(Int16* stream, uInt32 length, uInt32 end);
+
+#ifdef STELLA_AUDIO_THREAD
+    // Generates the fragments handed to the sound thread
+    void threadMain();
+#endif
+
   private:
     // TIASound emulation object
     TIASound myTIASound;
@@ -249,8 +327,15 @@ class Sound : public Serializable
     // Indicates if the sound device was successfully initialized
     bool myIsInitializedFlag;
 
-    // Indicates the cycle when a sound register was last set
-    Int32 myLastRegisterSetCycle;
+    // Register writes are stamped with their system cycle plus this
+    // offset, which takes up the resets of the system cycle counter
+    uInt32 myCycleOffset;
+
+    // Stamp of the cycle at which the next sound fragment starts
+    uInt32 myFragmentStartCycle;
+
+    // The longest stretch of CPU cycles a sound fragment is spread over
+    enum { kMaxFragmentCycles = 0x10000 };
 
     // Indicates the number of channels (mono or stereo)
     uInt32 myNumChannels;
@@ -263,6 +348,27 @@ class Sound : public Serializable
 
     // Queue of TIA register writes
     RegWriteQueue myRegWriteQueue;
+
+    // Converts the samples to the output rate (NULL at the TIA rate)
+    Resampler* myResampler;
+
+#ifdef STELLA_AUDIO_THREAD
+    // Longest fragment the sound thread generates
+    enum { kMaxThreadFragment = 4096 };
+
+    // The sound thread (NULL when not running), and the lock and
+    // condition guarding the fragment handed to it
+    std::thread* myThread;
+    mutable std::mutex myThreadMutex;
+    mutable std::condition_variable myThreadCondition;
+
+    // The fragment handed to the thread, or generated by it
+    Int16* myThreadFragment;
+    uInt32 myThreadLength;
+    uInt32 myThreadEnd;
+    bool myThreadBusy;
+    bool myThreadQuit;
+#endif
 };
 
 #endif
@@ -385,7 +385,56 @@ void Cartridge::triggerReadFromWritePort(uInt16 address)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Cartridge::createCodeAccessBase(uInt32 size)
 {
+#ifdef DEBUGGER_SUPPORT
+  myCodeAccessBase = new uInt8[size];
+  memset(myCodeAccessBase, 0, size);
+#else
   myCodeAccessBase = NULL;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 Cartridge::musicClocks(Int32 cycles, MusicClockFraction& fraction)
+{
+#ifdef STELLA_FIXED_POINT
+  // A CPU cycle is 20000 / 1193191.67 = 2400 / 143183 OSC clocks; long
+  // gaps are taken in pieces so that the products fit in 32 bits
+  Int32 wholeClocks = 0;
+  while(cycles > 0)
+  {
+    uInt32 chunk = cycles < 0x10000 ? cycles : 0x10000;
+    uInt32 clocks = chunk * 2400 + fraction;
+    wholeClocks += clocks / 143183;
+    fraction = clocks % 143183;
+    cycles -= chunk;
+  }
+  return wholeClocks;
+#else
+  double clocks = ((20000.0 * cycles) / 1193191.66666667) + fraction;
+  Int32 wholeClocks = (Int32)clocks;
+  fraction = clocks - (double)wholeClocks;
+  return wholeClocks;
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Cartridge::saveMusicClockFraction(MusicClockFraction fraction)
+{
+#ifdef STELLA_FIXED_POINT
+  return (uInt32)(((uInt64)fraction * 100000000) / 143183);
+#else
+  return (uInt32)(fraction * 100000000.0);
+#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Cartridge::MusicClockFraction Cartridge::loadMusicClockFraction(uInt32 value)
+{
+#ifdef STELLA_FIXED_POINT
+  return (uInt32)(((uInt64)value * 143183) / 100000000);
+#else
+  return (double)value / 100000000.0;
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
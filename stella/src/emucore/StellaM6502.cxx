@@ -24,13 +24,96 @@
   #define DISASM_DATA  0
   #define DISASM_ROW   0
   #define DISASM_NONE  0
+#include "M6532.hxx"
+#include "Profiler.hxx"
 #include "Settings.hxx"
 
 #include "M6502.hxx"
 
+// GCC and Clang can jump from the end of one instruction straight to the
+// code of the next through a table of label addresses, which predicts
+// far better than going back through a single switch
+#if defined(__GNUC__) && !defined(M6502_NO_COMPUTED_GOTO)
+  #define M6502_COMPUTED_GOTO
+#endif
+
+// The addresses accessed by each instruction and the number of
+// instructions executed are only kept for the debugger
+#ifdef DEBUGGER_SUPPORT
+  #define M6502_BEGIN_INSTRUCTION \
+    myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0;
+  #define M6502_END_INSTRUCTION \
+    myTotalInstructionCount++;
+#else
+  #define M6502_BEGIN_INSTRUCTION
+  #define M6502_END_INSTRUCTION
+#endif
+
+// A branch back to the instruction before it may close a loop waiting
+// for the timer, which is skipped up to the read that leaves it; not
+// done with the debugger, which must see every instruction
+#ifndef DEBUGGER_SUPPORT
+  #define BRANCH_TAKEN \
+    if(operand == 0xfb) number -= skipTimerLoop(number);
+#endif
+
+#ifdef M6502_BLOCK_CACHE
+  // Takes the next instruction from the decoded block it is in, looking
+  // up the block when the last one has ended, a branch or interrupt has
+  // left it, or the code of its page may have changed, and does all that
+  // reading the code bytes one at a time would do in one go.  When there
+  // is no decoded instruction all of its code is read from memory first,
+  // as the instructions all read their operand before any other access;
+  // a block left empty for code that keeps being rewritten stays so.
+  #define M6502_FETCH_DECODED                                              \
+    if(PC != decodedPC || decoded == decodedEnd ||                         \
+       block->generation != *pageGeneration)                               \
+    {                                                                      \
+      block = myDecodedBlocks + (PC & (ourDecodedBlockCount - 1));         \
+      pageGeneration = pageGenerations + ((PC >> pageShift) & lastPage); \
+      if(block->address != PC ||                                           \
+         (block->generation != *pageGeneration &&                          \
+          block->rewrites < ourBlockRewriteLimit))                         \
+        block = decodedBlock(PC);                                          \
+      decoded = block->instruction;                                        \
+      decodedEnd = decoded + block->count;                                 \
+    }                                                                      \
+    if(decoded != decodedEnd)                                              \
+    {                                                                      \
+      const DecodedInstruction& instruction = *decoded++;                  \
+      const uInt8 length = instruction.length;                             \
+      myNumberOfDistinctAccesses += length - (PC == myLastAddress);        \
+      PC += length;                                                        \
+      decodedPC = PC;                                                      \
+      myLastAddress = PC - 1;                                              \
+      mySystem->incrementCycles(length * mySystemCyclesPerProcessorCycle); \
+      mySystem->setDataBusState(instruction.code[length - 1]);             \
+      myLastAccessWasRead = true;                                          \
+      IR = instruction.code[0];                                            \
+      operandBytes = instruction.code + 1;                                 \
+    }                                                                      \
+    else                                                                   \
+    {                                                                      \
+      IR = peek(PC++, DISASM_CODE);                                        \
+      uInt8 length = ourInstructionLengthTable[IR] & 0x7f;                 \
+      if(length > 1)                                                       \
+        fetched[0] = peek(PC++, DISASM_CODE);                              \
+      if(length > 2)                                                       \
+        fetched[1] = peek(PC++, DISASM_CODE);                              \
+      operandBytes = fetched;                                              \
+    }
+
+  // The operand bytes have been read along with the opcode
+  #define OPERAND_BYTE() (*operandBytes++)
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
   : myExecutionStatus(0),
+    myCycleLimit(0),
+#ifdef M6502_BLOCK_CACHE
+    myDecodedBlocks(0),
+#endif
     mySystem(0),
     mySettings(settings),
     mySystemCyclesPerProcessorCycle(systemCyclesPerProcessorCycle),
@@ -53,11 +136,19 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
     myInstructionSystemCycleTable[t] = ourInstructionCycleTable[t] *
         mySystemCyclesPerProcessorCycle;
   }
+
+#ifdef M6502_BLOCK_CACHE
+  myDecodedBlocks = new DecodedBlock[ourDecodedBlockCount];
+  memset(myDecodedBlocks, 0, ourDecodedBlockCount * sizeof(DecodedBlock));
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 M6502::~M6502()
 {
+#ifdef M6502_BLOCK_CACHE
+  delete[] myDecodedBlocks;
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -120,9 +211,15 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
   ////////////////////////////////////////////////
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
+#ifdef DEBUGGER_SUPPORT
   uInt8 result = mySystem->peek(address, flags);
+#else
+  uInt8 result = mySystem->peek(address);
+#endif
   myLastAccessWasRead = true;
+#ifdef DEBUGGER_SUPPORT
   myLastPeekAddress = address;
+#endif
   return result;
 }
 
@@ -141,28 +238,152 @@ inline void M6502::poke(uInt16 address, uInt8 value)
 
   mySystem->poke(address, value);
   myLastAccessWasRead = false;
+#ifdef DEBUGGER_SUPPORT
   myLastPokeAddress = address;
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool M6502::execute(uInt32 number)
+bool M6502::execute(uInt32 number, uInt32 cycleLimit)
 {
+  PROFILE_SCOPE(CPU);
+
   // Clear all of the execution status bits except for the fatal error bit
   myExecutionStatus &= FatalErrorBit;
+  myCycleLimit = cycleLimit;
+
+  // The cycles are only compared with the limit after each instruction
+  // when there is one, so running a whole frame doesn't pay for it
+  if(cycleLimit == 0xffffffff)
+    return executeInstructions<false>(number);
+  else
+    return executeInstructions<true>(number);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<bool CycleLimit>
+bool M6502::executeInstructions(uInt32 number)
+{
+#ifdef M6502_COMPUTED_GOTO
+  // The code of each opcode; the missing ones jam the processor
+  static const void* const ourInstructions[256] = {
+    &&op_0x00, &&op_0x01, &&illegal, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+    &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+    &&op_0x10, &&op_0x11, &&illegal, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+    &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+    &&op_0x20, &&op_0x21, &&illegal, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+    &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+    &&op_0x30, &&op_0x31, &&illegal, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+    &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+    &&op_0x40, &&op_0x41, &&illegal, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+    &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+    &&op_0x50, &&op_0x51, &&illegal, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+    &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+    &&op_0x60, &&op_0x61, &&illegal, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+    &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+    &&op_0x70, &&op_0x71, &&illegal, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+    &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+    &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+    &&op_0x88, &&op_0x89, &&op_0x8a, &&op_0x8b, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+    &&op_0x90, &&op_0x91, &&illegal, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+    &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+    &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+    &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+    &&op_0xb0, &&op_0xb1, &&illegal, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+    &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+    &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7,
+    &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+    &&op_0xd0, &&op_0xd1, &&illegal, &&op_0xd3, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7,
+    &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_0xdb, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_0xdf,
+    &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_0xe3, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_0xe7,
+    &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_0xeb, &&op_0xec, &&op_0xed, &&op_0xee, &&op_0xef,
+    &&op_0xf0, &&op_0xf1, &&illegal, &&op_0xf3, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_0xf7,
+    &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_0xfb, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_0xff
+  };
+#endif
 
   // Loop until execution is stopped or a fatal error occurs
   for(;;)
   {
-    for(; !myExecutionStatus && (number != 0); --number)
+#ifdef M6502_COMPUTED_GOTO
+    if(!myExecutionStatus && (number != 0))
+    {
+      uInt16 operandAddress, intermediateAddress;
+      uInt8 operand;
+#ifdef M6502_BLOCK_CACHE
+      const DecodedBlock* block = 0;
+      const DecodedInstruction* decoded = 0;
+      const DecodedInstruction* decodedEnd = 0;
+      const uInt32* pageGeneration = 0;
+      const uInt32* pageGenerations = mySystem->pageGenerations();
+      const uInt16 pageShift = mySystem->pageShift();
+      const uInt16 lastPage = mySystem->numberOfPages() - 1;
+      const uInt8* operandBytes;
+      uInt8 fetched[2];
+      uInt16 decodedPC = PC;
+#endif
+
+      #define INSTRUCTION(_opcode) op_##_opcode:
+      #define NEXT_INSTRUCTION                                  \
+        M6502_END_INSTRUCTION                                   \
+        if(!myExecutionStatus && (--number != 0) &&             \
+           (!CycleLimit || mySystem->cycles() < myCycleLimit))  \
+          goto nextInstruction;                                 \
+        goto instructionsDone;
+
+    nextInstruction:
+      operandAddress = intermediateAddress = 0;
+      operand = 0;
+      M6502_BEGIN_INSTRUCTION
+
+#ifdef M6502_BLOCK_CACHE
+      M6502_FETCH_DECODED
+#else
+      // Fetch instruction at the program counter
+      IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+#endif
+      goto *ourInstructions[IR];
+
+      // 6502 instruction emulation is generated by an M4 macro file
+      #include "M6502.ins"
+
+    illegal:
+      // Oops, illegal instruction executed so set fatal error flag
+      myExecutionStatus |= FatalErrorBit;
+      M6502_END_INSTRUCTION
+      --number;
+
+      #undef INSTRUCTION
+      #undef NEXT_INSTRUCTION
+    }
+  instructionsDone:
+#else
+#ifdef M6502_BLOCK_CACHE
+    const DecodedBlock* block = 0;
+    const DecodedInstruction* decoded = 0;
+    const DecodedInstruction* decodedEnd = 0;
+    const uInt32* pageGeneration = 0;
+    const uInt32* pageGenerations = mySystem->pageGenerations();
+    const uInt16 pageShift = mySystem->pageShift();
+    const uInt16 lastPage = mySystem->numberOfPages() - 1;
+    const uInt8* operandBytes;
+    uInt8 fetched[2];
+    uInt16 decodedPC = PC;
+#endif
+    for(; !myExecutionStatus && (number != 0) &&
+          (!CycleLimit || mySystem->cycles() < myCycleLimit); --number)
     {
       uInt16 operandAddress = 0, intermediateAddress = 0;
       uInt8 operand = 0;
 
-      // Reset the peek/poke address pointers
-      myLastPeekAddress = myLastPokeAddress = myDataAddressForPoke = 0;
+      M6502_BEGIN_INSTRUCTION
 
+#ifdef M6502_BLOCK_CACHE
+      M6502_FETCH_DECODED
+#else
       // Fetch instruction at the program counter
       IR = peek(PC++, DISASM_CODE);  // This address represents a code section
+#endif
 
       // Call code to execute the instruction
       switch(IR)
@@ -174,8 +395,9 @@ bool M6502::execute(uInt32 number)
           // Oops, illegal instruction executed so set fatal error flag
           myExecutionStatus |= FatalErrorBit;
       }
-      myTotalInstructionCount++;
+      M6502_END_INSTRUCTION
     }
+#endif
 
     // See if we need to handle an interrupt
     if((myExecutionStatus & MaskableInterruptBit) || 
@@ -199,8 +421,9 @@ bool M6502::execute(uInt32 number)
       return false;
     }
 
-    // See if we've executed the specified number of instructions
-    if(number == 0)
+    // See if we've executed the specified number of instructions, or run
+    // up to the cycle limit
+    if(number == 0 || (CycleLimit && mySystem->cycles() >= myCycleLimit))
     {
       // Yes, so answer that everything finished fine
       return true;
@@ -208,6 +431,174 @@ bool M6502::execute(uInt32 number)
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 M6502::skipTimerLoop(uInt32 number)
+{
+  // The loop is an absolute LDA/LDX/LDY/BIT followed by the branch that
+  // has just been taken.  All of its code, up to the dummy read the
+  // branch makes after its operand, must come from pages that can be
+  // read directly, so that skipping its reads can't be noticed.  Loops
+  // whose branch crosses a page are rare enough to be left alone.
+  const uInt16 end = PC + 5;
+  if((PC ^ end) & 0xff00)
+    return 0;
+
+  const uInt16 pageCount = mySystem->numberOfPages();
+  const uInt16 shift = mySystem->pageShift();
+  const uInt16 mask = mySystem->pageMask();
+  const System::PageAccess& first = mySystem->getPageAccess((PC >> shift) & (pageCount - 1));
+  const System::PageAccess& last = mySystem->getPageAccess((end >> shift) & (pageCount - 1));
+  if(!first.directPeekBase || !last.directPeekBase)
+    return 0;
+
+  uInt8 code[5];
+  for(uInt16 i = 0; i < 5; ++i)
+  {
+    uInt16 address = PC + i;
+    const System::PageAccess& access = (address >> shift) == (PC >> shift) ? first : last;
+    code[i] = access.directPeekBase[address & mask];
+  }
+  if(code[3] != IR || code[4] != 0xfb)
+    return 0;
+
+  const uInt8 load = code[0];
+  if(load != 0xad && load != 0xae && load != 0xac && load != 0x2c)
+    return 0;
+
+  // It must read INTIM or TIMINT straight from the 6532
+  const uInt16 timer = code[1] | (code[2] << 8);
+  if((timer & 0x1284) != 0x0284 ||
+     mySystem->getPageAccess((timer >> shift) & (pageCount - 1)).device !=
+       &mySystem->m6532())
+    return 0;
+
+  // One pass of the loop takes 4 + 3 cycles, and reads the timer in the
+  // last cycle of the load
+  const uInt32 accesses = 7;
+  const uInt32 period = accesses * mySystemCyclesPerProcessorCycle;
+  const uInt32 start = mySystem->cycles() + 4 * mySystemCyclesPerProcessorCycle;
+
+  // Skip whole passes only, and leave the instruction count as execute()
+  // would after them.  Nor go past the cycle limit, which the rest of the
+  // loop is left to reach; no pass beyond it is read, since reading the
+  // timer can change the 6532
+  const uInt32 now = mySystem->cycles();
+  if(myCycleLimit <= now)
+    return 0;
+  uInt32 limit = (number - 1) / 2;
+  if(limit > (myCycleLimit - now) / period)
+    limit = (myCycleLimit - now) / period;
+
+  M6532& riot = mySystem->m6532();
+  uInt32 count = 0;
+  uInt8 value = 0;
+  while(count < limit)
+  {
+    uInt32 until;
+    uInt8 v = riot.timerValue(timer, start + count * period, until);
+
+    bool n = v & 0x80, z = load == 0x2c ? !(A & v) : !v;
+    bool taken;
+    switch(IR)
+    {
+      case 0x10: taken = !n; break;                                 // BPL
+      case 0x30: taken = n; break;                                  // BMI
+      case 0x50: taken = !(load == 0x2c ? (v & 0x40) : V); break;   // BVC
+      case 0x70: taken = load == 0x2c ? (v & 0x40) : V; break;      // BVS
+      case 0x90: taken = !C; break;                                 // BCC
+      case 0xb0: taken = C; break;                                  // BCS
+      case 0xd0: taken = !z; break;                                 // BNE
+      default:   taken = z; break;                                  // BEQ
+    }
+    if(!taken)
+      break;
+
+    // The passes until the value may change read the same, with the same
+    // side effects as this one
+    riot.peekTimer(timer, start + count * period);
+    value = v;
+    uInt32 next = (until - start + period - 1) / period;
+    count = next > count + 1 ? next : count + 1;
+  }
+  if(count > limit)
+    count = limit;
+  if(count == 0)
+    return 0;
+
+  mySystem->incrementCycles(count * period);
+  myNumberOfDistinctAccesses += count * accesses;
+
+  switch(load)
+  {
+    case 0xad: A = value; break;
+    case 0xae: X = value; break;
+    case 0xac: Y = value; break;
+    default:   V = value & 0x40; break;
+  }
+  N = value & 0x80;
+  notZ = load == 0x2c ? (A & value) : value;
+
+  return 2 * count;
+}
+
+#ifdef M6502_BLOCK_CACHE
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const M6502::DecodedBlock* M6502::decodedBlock(uInt16 address)
+{
+  const uInt16 page = (address >> mySystem->pageShift()) &
+                      (mySystem->numberOfPages() - 1);
+  const uInt32 generation = mySystem->pageGenerations()[page];
+  DecodedBlock& block = myDecodedBlocks[address & (ourDecodedBlockCount - 1)];
+
+  // The block is kept as long as it still matches the code
+  const System::PageAccess& access = mySystem->getPageAccess(page);
+  const uInt16 mask = mySystem->pageMask();
+  const uInt8* code =
+      access.directPeekBase ? access.directPeekBase + (address & mask) : 0;
+  const bool sameCode = code && block.address == address && block.code == code;
+  bool matches = sameCode;
+  for(uInt32 i = 0, offset = 0; matches && i < block.count; ++i)
+  {
+    const DecodedInstruction& instruction = block.instruction[i];
+    for(uInt32 j = 0; matches && j < instruction.length; ++j)
+      matches = instruction.code[j] == code[offset++];
+  }
+  if(!matches)
+  {
+    // Decode up to the first jump, call or return, or one that can't be
+    // decoded; code that keeps being rewritten, as when it changes its
+    // own operands, is left to be read from memory instead
+    const uInt32 left = mask + 1 - (address & mask);
+    uInt32 offset = 0;
+    block.rewrites = sameCode ? block.rewrites + 1 : 0;
+    block.code = code;
+    block.address = address;
+    block.count = 0;
+    while(code && block.rewrites < ourBlockRewriteLimit &&
+          block.count < sizeof(block.instruction) / sizeof(block.instruction[0]))
+    {
+      const uInt8 decoded = ourInstructionLengthTable[code[offset]];
+      const uInt8 length = decoded & 0x7f;
+      if(length == 0 || offset + length > left)
+        break;
+
+      DecodedInstruction& instruction = block.instruction[block.count++];
+      memcpy(instruction.code, code + offset, length);
+      instruction.length = length;
+      offset += length;
+      if(decoded & 0x80)
+        break;
+    }
+  }
+
+  block.generation = generation;
+  if(block.count)
+    mySystem->watchCode(page);
+
+  return &block;
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::interruptHandler()
 {
@@ -357,3 +748,26 @@ uInt32 M6502::ourInstructionCycleTable[256] = {
     2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6,  // e
     2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7   // f
 };
+
+#ifdef M6502_BLOCK_CACHE
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt8 M6502::ourInstructionLengthTable[256] = {
+//  0     1     2     3     4     5     6     7     8     9     a     b     c     d     e     f
+    0x81, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03,  // 0
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // 1
+    0x81, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03,  // 2
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // 3
+    0x81, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x83, 0x03, 0x03, 0x03,  // 4
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // 5
+    0x81, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x83, 0x03, 0x03, 0x03,  // 6
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // 7
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03,  // 8
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // 9
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03,  // a
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // b
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03,  // c
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03,  // d
+    0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x03, 0x03,  // e
+    0x02, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x02, 0x01, 0x03, 0x01, 0x03, 0x03, 0x03, 0x03, 0x03   // f
+};
+#endif
@@ -123,17 +123,30 @@ void M6532::install(System& system, Device& device)
 
   // We're installing in a 2600 system
   for(int address = 0; address < 8192; address += (1 << shift))
-    if((address & 0x1080) == 0x0080)
+  {
+    if((address & 0x1080) != 0x0080)
+      continue;
+
+    // Unless another device has to see them, the pages of RAM are
+    // accessed directly by the system
+    if(&device == this && (address & 0x0200) == 0x0000 && shift <= 6)
+    {
+      uInt8* ram = &myRAM[address & 0x007f];
+      mySystem->setPageAccess(address >> shift,
+          System::PageAccess(ram, ram, 0, &device, System::PA_READWRITE));
+    }
+    else
       mySystem->setPageAccess(address >> shift, access);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 M6532::peek(uInt16 addr)
 {
-  // Access RAM directly.  Originally, accesses to RAM could bypass
-  // this method and its pages could be installed directly into the
-  // system.  However, certain cartridges (notably 4A50) can mirror
-  // the RAM address space, making it necessary to chain accesses.
+  // Access RAM directly.  Its pages are normally installed directly
+  // into the system and bypass this method; however, certain cartridges
+  // (notably 4A50) can mirror the RAM address space, making it necessary
+  // to chain accesses.
   if((addr & 0x1080) == 0x0080 && (addr & 0x0200) == 0x0000)
   {
     return myRAM[addr & 0x007f];
@@ -169,65 +182,111 @@ uInt8 M6532::peek(uInt16 addr)
     }
 
     case 0x04:    // INTIM - Timer Output
+    case 0x05:    // TIMINT/INSTAT - Interrupt Flag
     case 0x06:
+    case 0x07:
     {
-      // Timer Flag is always cleared when accessing INTIM
-      myInterruptFlag &= ~TimerBit;
+      return peekTimer(addr, mySystem->cycles());
+    }
 
-      // Get number of clocks since timer was set
-      Int32 timer = timerClocks();
+    default:
+    {    
+      return 0;
+    }
+  }
+}
 
-      // Note that this constant comes from z26, and corresponds to
-      // 256 intervals of T1024T (ie, the maximum that the timer should hold)
-      // I'm not sure why this is required, but quite a few ROMs fail
-      // if we just check >= 0.
-      if(!(timer & 0x40000))
-      {
-        // Return at 'divide by TIMxT' interval rate
-        return (timer >> myIntervalShift) & 0xff;
-      }
-      else
-      {
-        // Return at 'divide by 1' rate
-        uInt8 divByOne = timer & 0xff;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 M6532::peekTimer(uInt16 addr, uInt32 cycle)
+{
+  if(!(addr & 0x01))    // INTIM - Timer Output
+  {
+    // Timer Flag is always cleared when accessing INTIM
+    myInterruptFlag &= ~TimerBit;
 
-        // Timer flag has been updated; don't update it again on TIMINT read
-        if(divByOne != 0 && divByOne != 255)
-          myTimerFlagValid = true;
+    // Get number of clocks since timer was set
+    Int32 timer = timerClocks(cycle);
 
-        return divByOne;
-      }
+    // Note that this constant comes from z26, and corresponds to
+    // 256 intervals of T1024T (ie, the maximum that the timer should hold)
+    // I'm not sure why this is required, but quite a few ROMs fail
+    // if we just check >= 0.
+    if(!(timer & 0x40000))
+    {
+      // Return at 'divide by TIMxT' interval rate
+      return (timer >> myIntervalShift) & 0xff;
     }
-
-    case 0x05:    // TIMINT/INSTAT - Interrupt Flag
-    case 0x07:
+    else
     {
-      // Update timer flag if it is invalid and timer has expired
-      if(!myTimerFlagValid && timerClocks() < 0)
-      {
-        myInterruptFlag |= TimerBit;
+      // Return at 'divide by 1' rate
+      uInt8 divByOne = timer & 0xff;
+
+      // Timer flag has been updated; don't update it again on TIMINT read
+      if(divByOne != 0 && divByOne != 255)
         myTimerFlagValid = true;
-      }
-      // PA7 Flag is always cleared after accessing TIMINT
-      uInt8 result = myInterruptFlag;
-      myInterruptFlag &= ~PA7Bit;
-      return result;
+
+      return divByOne;
     }
+  }
+  else                  // TIMINT/INSTAT - Interrupt Flag
+  {
+    // Update timer flag if it is invalid and timer has expired
+    if(!myTimerFlagValid && timerClocks(cycle) < 0)
+    {
+      myInterruptFlag |= TimerBit;
+      myTimerFlagValid = true;
+    }
+    // PA7 Flag is always cleared after accessing TIMINT
+    uInt8 result = myInterruptFlag;
+    myInterruptFlag &= ~PA7Bit;
+    return result;
+  }
+}
 
-    default:
-    {    
-      return 0;
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 M6532::timerValue(uInt16 addr, uInt32 cycle, uInt32& until) const
+{
+  // Answers what peekTimer() would, without its side effects
+  Int32 timer = timerClocks(cycle);
+  if(!(addr & 0x01))    // INTIM - Timer Output
+  {
+    if(!(timer & 0x40000))
+    {
+      // Steady until the timer reaches the next interval
+      until = cycle + (timer & ((1 << myIntervalShift) - 1)) + 1;
+      return (timer >> myIntervalShift) & 0xff;
     }
+    else
+    {
+      until = cycle + 1;
+      return timer & 0xff;
+    }
+  }
+  else                  // TIMINT/INSTAT - Interrupt Flag
+  {
+    uInt8 result = myInterruptFlag;
+    if(!myTimerFlagValid && timer < 0)
+      result |= TimerBit;
+
+    // Only the timer expiring or this read clearing the PA7 flag change
+    // the answer while the CPU runs; the pins are updated between frames
+    if(result & PA7Bit)
+      until = cycle + 1;
+    else if(!myTimerFlagValid && timer >= 0)
+      until = cycle + timer + 1;
+    else
+      until = cycle + 0x40000000;
+    return result;
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool M6532::poke(uInt16 addr, uInt8 value)
 {
-  // Access RAM directly.  Originally, accesses to RAM could bypass
-  // this method and its pages could be installed directly into the
-  // system.  However, certain cartridges (notably 4A50) can mirror
-  // the RAM address space, making it necessary to chain accesses.
+  // Access RAM directly.  Its pages are normally installed directly
+  // into the system and bypass this method; however, certain cartridges
+  // (notably 4A50) can mirror the RAM address space, making it necessary
+  // to chain accesses.
   if((addr & 0x1080) == 0x0080 && (addr & 0x0200) == 0x0000)
   {
     myRAM[addr & 0x007f] = value;
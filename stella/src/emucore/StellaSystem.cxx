@@ -36,6 +36,11 @@ System::System(uInt16 n, uInt16 m)
     myDataBusState(0),
     myDataBusLocked(false),
     mySystemInAutodetect(false)
+#ifdef M6502_BLOCK_CACHE
+  , myNumberOfCodePages(0),
+    myTIADevice(0),
+    myM6532Device(0)
+#endif
 {
   // Create a new random number generator
   myRandom = new Random();
@@ -44,6 +49,15 @@ System::System(uInt16 n, uInt16 m)
   myPageAccessTable = new PageAccess[myNumberOfPages];
   myPageIsDirtyTable = new bool[myNumberOfPages];
 
+#ifdef M6502_BLOCK_CACHE
+  // Allocate the tables for watching decoded code
+  myCodeWatch = new uInt8[myNumberOfPages];
+  myPageGenerations = new uInt32[myNumberOfPages];
+  myCodePages = new uInt16[myNumberOfPages];
+  memset(myCodeWatch, 0, myNumberOfPages);
+  memset(myPageGenerations, 0, myNumberOfPages * sizeof(uInt32));
+#endif
+
   // Initialize page access table
   PageAccess access;
   access.directPeekBase = 0;
@@ -75,6 +89,12 @@ System::~System()
   delete[] myPageAccessTable;
   delete[] myPageIsDirtyTable;
 
+#ifdef M6502_BLOCK_CACHE
+  delete[] myCodeWatch;
+  delete[] myPageGenerations;
+  delete[] myCodePages;
+#endif
+
   // Free the random number generator
   delete myRandom;
 }
@@ -98,6 +118,11 @@ void System::reset(bool autodetect)
 
   // There are no dirty pages upon startup
   clearDirtyPages();
+
+#ifdef M6502_BLOCK_CACHE
+  // The devices have reset their memory
+  codeChanged();
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -125,6 +150,9 @@ void System::attach(M6532* m6532)
 {
   // Remember the processor
   myM6532 = m6532;
+#ifdef M6502_BLOCK_CACHE
+  myM6532Device = m6532;
+#endif
 
   // Attach it as a normal device
   attach((Device*) m6532);
@@ -134,6 +162,9 @@ void System::attach(M6532* m6532)
 void System::attach(TIA* tia)
 {
   myTIA = tia;
+#ifdef M6502_BLOCK_CACHE
+  myTIADevice = tia;
+#endif
   attach((Device*) tia);
 }
 
@@ -153,9 +184,120 @@ void System::resetCycles()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void System::setPageAccess(uInt16 page, const PageAccess& access)
 {
+#ifdef M6502_BLOCK_CACHE
+  // The page may now read other code, which is watched once the 6502
+  // has decoded it; selecting the bank it already reads changes nothing
+  const PageAccess& current = myPageAccessTable[page];
+  if(current.directPeekBase != access.directPeekBase ||
+     current.directPokeBase != access.directPokeBase ||
+     current.device != access.device)
+  {
+    ++myPageGenerations[page];
+    if(myCodeWatch[page] & WatchCode)
+    {
+      for(uInt16 i = 0; i < myNumberOfCodePages; ++i)
+      {
+        if(myCodePages[i] == page)
+        {
+          myCodePages[i] = myCodePages[--myNumberOfCodePages];
+          break;
+        }
+      }
+    }
+    // Until its first write or device access, the page is watched if it
+    // may reach code at all; working out which it does reach is left to
+    // then, as most pages are mapped again without being written
+    myCodeWatch[page] = 0;
+    if(myNumberOfCodePages)
+    {
+      if(access.directPokeBase)
+        myCodeWatch[page] |= WatchPoke;
+      if(access.device != myTIADevice && access.device != myM6532Device)
+        myCodeWatch[page] |= WatchDevice;
+    }
+  }
+#endif
+
   myPageAccessTable[page] = access;
 }
 
+#ifdef M6502_BLOCK_CACHE
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::codeChanged()
+{
+  for(uInt32 page = 0; page < myNumberOfPages; ++page)
+  {
+    ++myPageGenerations[page];
+    myCodeWatch[page] = 0;
+  }
+  myNumberOfCodePages = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::addCodePage(uInt16 page)
+{
+  myCodePages[myNumberOfCodePages++] = page;
+  myCodeWatch[page] |= WatchCode;
+
+  // Watch the pages whose writes reach its memory, and the other pages of
+  // its device, unless that is the TIA or 6532, which hold no code that
+  // their accesses could change
+  const PageAccess& code = myPageAccessTable[page];
+  const bool watchDevice =
+      code.device != myTIADevice && code.device != myM6532Device;
+  for(uInt32 i = 0; i < myNumberOfPages; ++i)
+  {
+    const PageAccess& access = myPageAccessTable[i];
+    if(access.directPokeBase &&
+       access.directPokeBase <= code.directPeekBase + myPageMask &&
+       code.directPeekBase <= access.directPokeBase + myPageMask)
+      myCodeWatch[i] |= WatchPoke;
+    if(watchDevice && access.device == code.device)
+      myCodeWatch[i] |= WatchDevice;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::codeWritten(uInt16 page, const uInt8* byte)
+{
+  // Only the code pages reading the byte written have changed
+  const uInt8* poke = myPageAccessTable[page].directPokeBase;
+  bool watched = false;
+  for(uInt16 i = 0; i < myNumberOfCodePages; ++i)
+  {
+    const uInt8* code = myPageAccessTable[myCodePages[i]].directPeekBase;
+    if(code <= byte && byte <= code + myPageMask)
+      ++myPageGenerations[myCodePages[i]];
+    if(poke <= code + myPageMask && code <= poke + myPageMask)
+      watched = true;
+  }
+
+  // The code pages the page was watched for may have been mapped again
+  if(!watched)
+    myCodeWatch[page] &= ~WatchPoke;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::deviceAccessed(uInt16 page)
+{
+  // The device can only have changed the code pages of its own
+  Device* device = myPageAccessTable[page].device;
+  bool watched = false;
+  for(uInt16 i = 0; i < myNumberOfCodePages; ++i)
+  {
+    if(myPageAccessTable[myCodePages[i]].device == device)
+    {
+      ++myPageGenerations[myCodePages[i]];
+      watched = true;
+    }
+  }
+
+  // The code pages the device was watched for may have been mapped again
+  if(!watched)
+    myCodeWatch[page] &= ~WatchDevice;
+}
+#endif
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const System::PageAccess& System::getPageAccess(uInt16 page) const
 {
@@ -194,45 +336,6 @@ void System::clearDirtyPages()
     myPageIsDirtyTable[i] = false;
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 System::peek(uInt16 addr, uInt8 flags)
-{
-  uInt8 result;
-  PageAccess& access = myPageAccessTable[(addr & myAddressMask) >> myPageShift];
-
-  // See if this page uses direct accessing or not 
-  if(access.directPeekBase)
-    result = *(access.directPeekBase + (addr & myPageMask));
-  else
-    result = access.device->peek(addr);
-
-  myDataBusState = result;
-
-  return result;
-}
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void System::poke(uInt16 addr, uInt8 value)
-{
-  uInt16 page = (addr & myAddressMask) >> myPageShift;
-  PageAccess& access = myPageAccessTable[page];
-  
-  // See if this page uses direct accessing or not 
-  if(access.directPokeBase)
-  {
-    // Since we have direct access to this poke, we can dirty its page
-    *(access.directPokeBase + (addr & myPageMask)) = value;
-    myPageIsDirtyTable[page] = true;
-  }
-  else
-  {
-    // The specific device informs us if the poke succeeded
-    myPageIsDirtyTable[page] = access.device->poke(addr, value);
-  }
-
-  myDataBusState = value;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 System::getAccessFlags(uInt16 addr)
 {
@@ -283,6 +386,11 @@ bool System::load(Serializer& in)
    myCycles = in.getInt();
    myDataBusState = in.getByte();
 
+#ifdef M6502_BLOCK_CACHE
+   // The memory of the devices is about to be replaced
+   codeChanged();
+#endif
+
    // Next, load state for the CPU
    if(!myM6502->load(in))
       return false;
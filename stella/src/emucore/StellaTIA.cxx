@@ -26,6 +26,7 @@
 #include "Control.hxx"
 #include "Device.hxx"
 #include "M6502.hxx"
+#include "Profiler.hxx"
 #include "Settings.hxx"
 #include "Sound.hxx"
 #include "System.hxx"
@@ -35,6 +36,16 @@
 
 #define HBLANK 68
 
+// Objects are composed 16 pixels at a time with SSE2 or NEON when the
+// compiler targets them; define TIA_NO_SIMD to always use the scalar loop
+#if !defined(TIA_NO_SIMD) && defined(__SSE2__)
+  #include <emmintrin.h>
+  #define TIA_SIMD_SSE2
+#elif !defined(TIA_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+  #include <arm_neon.h>
+  #define TIA_SIMD_NEON
+#endif
+
 #define CLAMP_POS(reg) if(reg < 0) { reg += 160; }  reg %= 160;
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -47,26 +58,37 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
     myMaximumNumberOfScanlines(262),
     myStartScanline(0),
     myColorLossEnabled(false),
+    myRenderingEnabled(true),
     myPartialFrameFlag(false),
     myAutoFrameEnabled(false),
     myFrameCounter(0),
     myPALFrameCounter(0),
     myBitsEnabled(true),
-    myCollisionsEnabled(true)
+    myCollisionsEnabled(true),
+    myNumCollisionSpans(0)
    
 {
   // Allocate buffers for two frame buffers
   myCurrentFrameBuffer = new uInt8[160 * 320];
   myPreviousFrameBuffer = new uInt8[160 * 320];
 
+  // Frames are only written to the internal buffers until told otherwise
+  setDirectOutput(0, 0, 0, 0);
+  setScanlineCallback(0, 0);
+  myOutputPointer = myCurrentFrameBuffer;
+  myScanlinesReported = 0;
+
   // Make sure all TIA bits are enabled
   enableBits(true);
 
   // Turn off debug colours (this also sets up the PriorityEncoder)
   toggleFixedColors(0);
 
-  // Compute all of the mask tables
-  TIATables::computeAllTables();
+#ifdef TIA_SMALL_TABLES
+  // None of the mask table rows have been built yet
+  for(uInt32 i = 0; i < 5; ++i)
+    myMaskRowIds[i] = ~0u;
+#endif
 
   // Zero audio registers
   myAUDV0 = myAUDV1 = myAUDF0 = myAUDF1 = myAUDC0 = myAUDC1 = 0;
@@ -109,6 +131,7 @@ void TIA::reset()
   myVDELP0 = myVDELP1 = myVDELBL = myRESMP0 = myRESMP1 = false;
   myCollision = 0;
   myCollisionEnabledMask = 0xFFFFFFFF;
+  myNumCollisionSpans = 0;
   myPOSP0 = myPOSP1 = myPOSM0 = myPOSM1 = myPOSBL = 0;
 
   // Some default values for the "current" variables
@@ -137,11 +160,11 @@ void TIA::reset()
   myFrameCounter = myPALFrameCounter = 0;
   myScanlineCountForLastFrame = 0;
 
-  myP0Mask = &TIATables::PxMask[0][0][0];
-  myP1Mask = &TIATables::PxMask[0][0][0];
-  myM0Mask = &TIATables::MxMask[0][0][0];
-  myM1Mask = &TIATables::MxMask[0][0][0];
-  myBLMask = &TIATables::BLMask[0][0];
+  myP0Mask = pxMaskRow(P0MaskRow, 0, 0);
+  myP1Mask = pxMaskRow(P1MaskRow, 0, 0);
+  myM0Mask = mxMaskRow(M0MaskRow, 0, 0);
+  myM1Mask = mxMaskRow(M1MaskRow, 0, 0);
+  myBLMask = blMaskRow(0);
   myPFMask = TIATables::PFMask[0];
 
   // Recalculate the size of the display
@@ -157,6 +180,8 @@ void TIA::frameReset()
 
   // Reset pixel pointer and drawing flag
   myFramePointer = myCurrentFrameBuffer;
+  myOutputPointer = myCurrentFrameBuffer;
+  myScanlinesReported = 0;
 
   // Calculate color clock offsets for starting and stopping frame drawing
   // Note that although we always start drawing at scanline zero, the
@@ -169,6 +194,9 @@ void TIA::frameReset()
 
   if(myFramerate > 55.0)  // NTSC
   {
+#ifdef STELLA_FIXED_POINT
+    myDumpRate = 312942;  // 59.92 Hz
+#endif
     myFixedColor[P0Color]     = 0x30;
     myFixedColor[P1Color]     = 0x16;
     myFixedColor[M0Color]     = 0x38;
@@ -182,6 +210,9 @@ void TIA::frameReset()
   }
   else
   {
+#ifdef STELLA_FIXED_POINT
+    myDumpRate = 260716;  // 49.92 Hz
+#endif
     myFixedColor[P0Color]     = 0x62;
     myFixedColor[P1Color]     = 0x26;
     myFixedColor[M0Color]     = 0x68;
@@ -311,7 +342,7 @@ bool TIA::save(Serializer& out) const
     out.putBool(myVDELBL);
     out.putBool(myRESMP0);
     out.putBool(myRESMP1);
-    out.putShort(myCollision);
+    out.putShort(collisions());
     out.putInt(myCollisionEnabledMask);
     out.putByte(myCurrentGRP0);
     out.putByte(myCurrentGRP1);
@@ -420,6 +451,7 @@ bool TIA::load(Serializer& in)
     myRESMP1 = in.getBool();
     myCollision = in.getShort();
     myCollisionEnabledMask = in.getInt();
+    myNumCollisionSpans = 0;
     myCurrentGRP0 = in.getByte();
     myCurrentGRP1 = in.getByte();
 
@@ -518,6 +550,7 @@ bool TIA::loadDisplay(Serializer& in)
     // as it existed when the state was saved
     if(myPartialFrameFlag)
       myFramePointer += myFramePointerClocks;
+    myOutputPointer = myCurrentFrameBuffer;
   }
   catch(...)
   {
@@ -550,13 +583,49 @@ void TIA::update()
   endFrame();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::updateToScanline(uInt32 line)
+{
+  if(!myPartialFrameFlag)
+    startFrame();
+  myPartialFrameFlag = true;
+
+  // Run up to the first instruction ending at or past the scanline; the
+  // 6502 stops there by itself, even in a WSYNC or a skipped timer loop
+  M6502& cpu = mySystem->m6502();
+  Int32 target = myClockWhenFrameStarted + line * 228;
+  for(;;)
+  {
+    Int32 clock = mySystem->cycles() * 3;
+    if(clock >= target)
+      break;
+
+    // The frame ends as in update() when the 6502 stops at VSYNC or
+    // can't go on
+    if(!cpu.execute(25000, (target + 2) / 3) || !myPartialFrameFlag)
+    {
+      endFrame();
+      return true;
+    }
+  }
+
+  updateFrame(mySystem->cycles() * 3);
+  flushOutput();
+  return false;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::startFrame()
 {
   // This stuff should only happen at the beginning of a new frame.
-  uInt8* tmp = myCurrentFrameBuffer;
-  myCurrentFrameBuffer = myPreviousFrameBuffer;
-  myPreviousFrameBuffer = tmp;
+  // A frame that isn't drawn keeps the buffers as they are, so the last
+  // frame drawn stays current, and the one before it previous
+  if(myRenderingEnabled)
+  {
+    uInt8* tmp = myCurrentFrameBuffer;
+    myCurrentFrameBuffer = myPreviousFrameBuffer;
+    myPreviousFrameBuffer = tmp;
+  }
 
   // Remember the number of clocks which have passed on the current scanline
   // so that we can adjust the frame's starting clock by this amount.  This
@@ -577,6 +646,8 @@ inline void TIA::startFrame()
   // Reset frame buffer pointer
   myFramePointer = myCurrentFrameBuffer;
   myFramePointerClocks = 0;
+  myOutputPointer = myCurrentFrameBuffer;
+  myScanlinesReported = 0;
 
   // If color loss is enabled then update the color registers based on
   // the number of scanlines in the last frame that was generated
@@ -616,6 +687,9 @@ inline void TIA::endFrame()
 {
   uInt32 currentlines = scanlines();
 
+  // The frame may end in the middle of a scanline
+  flushOutput();
+
   // The TIA may generate frames that are 'invisible' to TV (they complete
   // before the first visible scanline)
   // Such 'short' frames can't simply be eliminated, since they're running
@@ -626,6 +700,11 @@ inline void TIA::endFrame()
     // Skip display of this frame, as if it wasn't generated at all
     startFrame();
     myFrameCounter--;  // This frame doesn't contribute to frame count
+
+    // The last frame is shown again, instead of the lines output so far
+    outputPixels(myCurrentFrameBuffer, myCurrentFrameBuffer + 160 * 320);
+    if(myScanlineCallback)
+      reportScanlines(myFrameHeight);
     return;
   }
 
@@ -641,6 +720,10 @@ inline void TIA::endFrame()
   // otherwise they won't know anything has changed
   // Hence, the front buffer is set to pixel 0, and the back to pixel 1
 
+  // The direct output has the frame as far as it was drawn; the rest of
+  // the frame buffer is shown along with it, whatever it holds
+  uInt8* undrawn = myFramePointer;
+
   // Did we generate too many scanlines?
   // (usually caused by VBLANK/VSYNC taking too long or not occurring at all)
   // If so, blank entire viewable area
@@ -651,6 +734,8 @@ inline void TIA::endFrame()
     {
       memset(myCurrentFrameBuffer, 0, 160 * 320);
       memset(myPreviousFrameBuffer, 1, 160 * 320);
+      undrawn = myCurrentFrameBuffer;
+      myScanlinesReported = 0;
     }
   }
   // Did the number of scanlines decrease?
@@ -662,9 +747,19 @@ inline void TIA::endFrame()
            stride = (previousCount - myScanlineCountForLastFrame) * 160;
     memset(myCurrentFrameBuffer + offset, 0, stride);
     memset(myPreviousFrameBuffer + offset, 1, stride);
+    if(undrawn > myCurrentFrameBuffer + offset)
+      undrawn = myCurrentFrameBuffer + offset;
   }
+  outputPixels(undrawn, myCurrentFrameBuffer + 160 * 320);
+
+  // Whatever the frame didn't draw is part of it too
+  if(myScanlineCallback)
+    reportScanlines(myFrameHeight);
 
   // Recalculate framerate. attempting to auto-correct for scanline 'jumps'
+  // frameReset() never enables this, so the fixed-point build leaves it
+  // out rather than carry floating point work it can't use
+#ifndef STELLA_FIXED_POINT
   if(myAutoFrameEnabled)
   {
     myFramerate = (myScanlineCountForLastFrame > 285 ? 15600.0 : 15720.0) /
@@ -678,6 +773,7 @@ inline void TIA::endFrame()
     if(offset > myStopDisplayOffset && offset < 228 * 320)
       myStopDisplayOffset = offset;
   }
+#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -876,6 +972,369 @@ bool TIA::driveUnusedPinsRandom(uInt8 mode)
   return myTIAPinsDriven;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Append the parts of the given mask row runs that fall into pixels
+// [hpos, hend) of the scanline, as (start << 8) | end; the row is indexed
+// starting at 'offset' for pixel 0, and repeats every 160 entries
+static inline uInt32 addObjectSpans(uInt16* spans, uInt32 count,
+    const TIATables::MaskRuns& runs, Int32 offset, uInt32 hpos, uInt32 hend)
+{
+  for(uInt32 i = 0; i < runs.count; ++i)
+  {
+    Int32 start = runs.start[i] - offset;
+    if(start < 0)
+      start += 160;
+    Int32 end = start + runs.end[i] - runs.start[i];
+
+    // A run past the right edge continues at the left one
+    if(end > 160)
+    {
+      uInt32 wrapEnd = end - 160 < (Int32)hend ? end - 160 : hend;
+      if(hpos < wrapEnd)
+        spans[count++] = (hpos << 8) | wrapEnd;
+      end = 160;
+    }
+    if(start < (Int32)hpos)  start = hpos;
+    if(end > (Int32)hend)    end = hend;
+    if(start < end)
+      spans[count++] = (start << 8) | end;
+  }
+  return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderPlayfieldSpans(uInt8* line, uInt32 hpos, uInt32 hend,
+                               uInt8 enabledObjects)
+{
+  // Without moving objects each pixel is one of four colors: background
+  // or playfield, on the left or right half (which differ in score mode)
+  uInt8 colors[2][2];
+  for(uInt32 side = 0; side < 2; ++side)
+  {
+    colors[side][0] = myColorPtr[myPriorityEncoder[side]
+        [myPlayfieldPriorityAndScore]];
+    colors[side][1] = myColorPtr[myPriorityEncoder[side]
+        [PFBit | myPlayfieldPriorityAndScore]];
+  }
+  uInt32 pf = (enabledObjects & PFBit) ? myPF : 0;
+
+  // The playfield changes at most every four pixels, so only look at the
+  // start of each group of four
+  while(hpos < hend)
+  {
+    uInt8 color = colors[hpos < 80 ? 0 : 1][(pf & myPFMask[hpos]) != 0];
+    uInt32 end = (hpos | 3) + 1;
+    while(end < hend &&
+          colors[end < 80 ? 0 : 1][(pf & myPFMask[end]) != 0] == color)
+      end += 4;
+    if(end > hend)
+      end = hend;
+
+    // Most runs are a single playfield bit wide, too short for memset
+    if(end - hpos >= 32)
+      memset(line + hpos, color, end - hpos);
+    else
+      for(; hpos < end; ++hpos)
+        line[hpos] = color;
+    hpos = end;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderSpans(uInt8* line, uInt32 hpos, uInt32 hend,
+                      uInt8 enabledObjects, uInt16* spans, uInt32 numSpans)
+{
+  // Spans are encoded as (start << 8) | end, so sorting them sorts by
+  // start position; overlapping spans are merged while drawing
+  for(uInt32 i = 1; i < numSpans; ++i)
+  {
+    uInt16 span = spans[i];
+    uInt32 j = i;
+    for(; j > 0 && spans[j - 1] > span; --j)
+      spans[j] = spans[j - 1];
+    spans[j] = span;
+  }
+
+  for(uInt32 i = 0; i < numSpans; )
+  {
+    uInt32 start = spans[i] >> 8, end = spans[i] & 0xFF;
+    for(++i; i < numSpans && (uInt32)(spans[i] >> 8) <= end; ++i)
+      if((uInt32)(spans[i] & 0xFF) > end)
+        end = spans[i] & 0xFF;
+
+    if(hpos < start)
+      renderPlayfieldSpans(line, hpos, start, enabledObjects);
+    renderPixels(line, start, end, enabledObjects);
+    hpos = end;
+  }
+  if(hpos < hend)
+    renderPlayfieldSpans(line, hpos, hend, enabledObjects);
+}
+
+#if defined(TIA_SIMD_SSE2) || defined(TIA_SIMD_NEON)
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Compute the 'enabled' object bits of 16 consecutive pixels, given the
+// mask pointers already advanced to the first of them; objects that are
+// switched off have a zero graphics value (pf, grp0/1) or bit (bl, m0, m1)
+// Answers true if any pixel has two or more objects, i.e. may collide
+static inline bool buildObjectBits(uInt8* enabled,
+    const uInt32* pfMask, uInt32 pf, const uInt8* blMask, uInt8 bl,
+    const uInt8* p0Mask, uInt8 grp0, const uInt8* m0Mask, uInt8 m0,
+    const uInt8* p1Mask, uInt8 grp1, const uInt8* m1Mask, uInt8 m1)
+{
+#if defined(TIA_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i pfv = _mm_set1_epi32(pf);
+
+  // Playfield masks are 32 bits per pixel; narrow 'pixel is clear' to bytes
+  __m128i pf0 = _mm_cmpeq_epi32(_mm_and_si128(pfv,
+      _mm_loadu_si128((const __m128i*)(pfMask + 0))), zero);
+  __m128i pf1 = _mm_cmpeq_epi32(_mm_and_si128(pfv,
+      _mm_loadu_si128((const __m128i*)(pfMask + 4))), zero);
+  __m128i pf2 = _mm_cmpeq_epi32(_mm_and_si128(pfv,
+      _mm_loadu_si128((const __m128i*)(pfMask + 8))), zero);
+  __m128i pf3 = _mm_cmpeq_epi32(_mm_and_si128(pfv,
+      _mm_loadu_si128((const __m128i*)(pfMask + 12))), zero);
+  __m128i pfClear = _mm_packs_epi16(_mm_packs_epi32(pf0, pf1),
+                                    _mm_packs_epi32(pf2, pf3));
+
+  __m128i bits = _mm_andnot_si128(pfClear, _mm_set1_epi8(PFBit));
+  bits = _mm_or_si128(bits, _mm_andnot_si128(_mm_cmpeq_epi8(
+      _mm_loadu_si128((const __m128i*)blMask), zero), _mm_set1_epi8(bl)));
+  bits = _mm_or_si128(bits, _mm_andnot_si128(_mm_cmpeq_epi8(_mm_and_si128(
+      _mm_loadu_si128((const __m128i*)p1Mask), _mm_set1_epi8(grp1)), zero),
+      _mm_set1_epi8(P1Bit)));
+  bits = _mm_or_si128(bits, _mm_andnot_si128(_mm_cmpeq_epi8(
+      _mm_loadu_si128((const __m128i*)m1Mask), zero), _mm_set1_epi8(m1)));
+  bits = _mm_or_si128(bits, _mm_andnot_si128(_mm_cmpeq_epi8(_mm_and_si128(
+      _mm_loadu_si128((const __m128i*)p0Mask), _mm_set1_epi8(grp0)), zero),
+      _mm_set1_epi8(P0Bit)));
+  bits = _mm_or_si128(bits, _mm_andnot_si128(_mm_cmpeq_epi8(
+      _mm_loadu_si128((const __m128i*)m0Mask), zero), _mm_set1_epi8(m0)));
+  _mm_storeu_si128((__m128i*)enabled, bits);
+
+  // x & (x - 1) is non-zero when x has more than one bit set
+  __m128i multiple = _mm_and_si128(bits,
+      _mm_sub_epi8(bits, _mm_set1_epi8(1)));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(multiple, zero)) != 0xFFFF;
+#else
+  const uint32x4_t pfv = vdupq_n_u32(pf);
+
+  // Playfield masks are 32 bits per pixel; narrow 'pixel is set' to bytes
+  uint16x8_t pfLo = vcombine_u16(
+      vmovn_u32(vtstq_u32(vld1q_u32((const uint32_t*)pfMask + 0), pfv)),
+      vmovn_u32(vtstq_u32(vld1q_u32((const uint32_t*)pfMask + 4), pfv)));
+  uint16x8_t pfHi = vcombine_u16(
+      vmovn_u32(vtstq_u32(vld1q_u32((const uint32_t*)pfMask + 8), pfv)),
+      vmovn_u32(vtstq_u32(vld1q_u32((const uint32_t*)pfMask + 12), pfv)));
+  uint8x16_t pfSet = vcombine_u8(vmovn_u16(pfLo), vmovn_u16(pfHi));
+
+  uint8x16_t bits = vandq_u8(pfSet, vdupq_n_u8(PFBit));
+  uint8x16_t mask = vld1q_u8(blMask);
+  bits = vorrq_u8(bits, vandq_u8(vtstq_u8(mask, mask), vdupq_n_u8(bl)));
+  bits = vorrq_u8(bits, vandq_u8(vtstq_u8(vld1q_u8(p1Mask),
+      vdupq_n_u8(grp1)), vdupq_n_u8(P1Bit)));
+  mask = vld1q_u8(m1Mask);
+  bits = vorrq_u8(bits, vandq_u8(vtstq_u8(mask, mask), vdupq_n_u8(m1)));
+  bits = vorrq_u8(bits, vandq_u8(vtstq_u8(vld1q_u8(p0Mask),
+      vdupq_n_u8(grp0)), vdupq_n_u8(P0Bit)));
+  mask = vld1q_u8(m0Mask);
+  bits = vorrq_u8(bits, vandq_u8(vtstq_u8(mask, mask), vdupq_n_u8(m0)));
+  vst1q_u8(enabled, bits);
+
+  // x & (x - 1) is non-zero when x has more than one bit set
+  uint8x16_t multiple = vandq_u8(bits, vsubq_u8(bits, vdupq_n_u8(1)));
+  uint64x2_t any = vreinterpretq_u64_u8(multiple);
+  return (vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) != 0;
+#endif
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::recordCollisions(uInt32 hpos, uInt32 hend, uInt8 enabledObjects)
+{
+  CollisionSpan span;
+  span.pf   = (enabledObjects & PFBit) ? myPF : 0;
+  span.bl   = enabledObjects & BLBit;
+  span.grp0 = (enabledObjects & P0Bit) ? myCurrentGRP0 : 0;
+  span.m0   = myM0Mask != TIATables::DisabledMask ? enabledObjects & M0Bit : 0;
+  span.grp1 = (enabledObjects & P1Bit) ? myCurrentGRP1 : 0;
+  span.m1   = myM1Mask != TIATables::DisabledMask ? enabledObjects & M1Bit : 0;
+
+  // Nothing to do unless a collision not latched yet is possible at all
+  uInt8 visible = (span.pf ? PFBit : 0) | span.bl | (span.grp0 ? P0Bit : 0) |
+                  span.m0 | (span.grp1 ? P1Bit : 0) | span.m1;
+  if((TIATables::CollisionMask[visible] & ~myCollision) == 0)
+    return;
+
+  if(myNumCollisionSpans == kCollisionSpans)
+    resolveCollisions();
+
+  span.pfMask = myPFMask;
+  span.blMask = myBLMask;
+  span.p0Mask = myP0Mask;
+  span.m0Mask = myM0Mask;
+  span.p1Mask = myP1Mask;
+  span.m1Mask = myM1Mask;
+  span.hpos = hpos;
+  span.hend = hend;
+  myCollisionSpans[myNumCollisionSpans++] = span;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt16 TIA::collisions() const
+{
+  uInt16 collision = myCollision;
+
+  for(uInt32 s = 0; s < myNumCollisionSpans; ++s)
+  {
+    const CollisionSpan& span = myCollisionSpans[s];
+    uInt32 hpos = span.hpos;
+
+#if defined(TIA_SIMD_SSE2) || defined(TIA_SIMD_NEON)
+    uInt8 enabled[16];
+    for(; hpos + 16 <= span.hend; hpos += 16)
+    {
+      if(buildObjectBits(enabled, span.pfMask + hpos, span.pf,
+                         span.blMask + hpos, span.bl,
+                         span.p0Mask + hpos, span.grp0,
+                         span.m0Mask + hpos, span.m0,
+                         span.p1Mask + hpos, span.grp1,
+                         span.m1Mask + hpos, span.m1))
+      {
+        for(uInt32 i = 0; i < 16; ++i)
+          collision |= TIATables::CollisionMask[enabled[i]];
+      }
+    }
+#endif
+
+    for(; hpos < span.hend; ++hpos)
+    {
+      uInt8 enabled = (span.pf & span.pfMask[hpos]) ? PFBit : 0;
+
+      if(span.bl && span.blMask[hpos])
+        enabled |= BLBit;
+
+      if(span.grp1 & span.p1Mask[hpos])
+        enabled |= P1Bit;
+
+      if(span.m1 && span.m1Mask[hpos])
+        enabled |= M1Bit;
+
+      if(span.grp0 & span.p0Mask[hpos])
+        enabled |= P0Bit;
+
+      if(span.m0 && span.m0Mask[hpos])
+        enabled |= M0Bit;
+
+      collision |= TIATables::CollisionMask[enabled];
+    }
+  }
+
+  return collision;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::renderPixels(uInt8* line, uInt32 hpos, uInt32 hend,
+                       uInt8 enabledObjects)
+{
+#if defined(TIA_SIMD_SSE2) || defined(TIA_SIMD_NEON)
+  uInt32 pf   = (enabledObjects & PFBit) ? myPF : 0;
+  uInt8  grp0 = (enabledObjects & P0Bit) ? myCurrentGRP0 : 0;
+  uInt8  grp1 = (enabledObjects & P1Bit) ? myCurrentGRP1 : 0;
+  uInt8 enabled[16];
+
+  for(; hpos + 16 <= hend; hpos += 16)
+  {
+    buildObjectBits(enabled, myPFMask + hpos, pf,
+                    myBLMask + hpos, enabledObjects & BLBit,
+                    myP0Mask + hpos, grp0,
+                    myM0Mask + hpos, enabledObjects & M0Bit,
+                    myP1Mask + hpos, grp1,
+                    myM1Mask + hpos, enabledObjects & M1Bit);
+
+    for(uInt32 i = 0; i < 16; ++i)
+      line[hpos + i] = myColorPtr[myPriorityEncoder[hpos + i < 80 ? 0 : 1]
+          [enabled[i] | myPlayfieldPriorityAndScore]];
+  }
+#endif
+
+  for(; hpos < hend; ++hpos)
+  {
+    uInt8 enabled = ((enabledObjects & PFBit) &&
+                     (myPF & myPFMask[hpos])) ? PFBit : 0;
+
+    if((enabledObjects & BLBit) && myBLMask[hpos])
+      enabled |= BLBit;
+
+    if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
+      enabled |= P1Bit;
+
+    if((enabledObjects & M1Bit) && myM1Mask[hpos])
+      enabled |= M1Bit;
+
+    if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
+      enabled |= P0Bit;
+
+    if((enabledObjects & M0Bit) && myM0Mask[hpos])
+      enabled |= M0Bit;
+
+    line[hpos] = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
+        [enabled | myPlayfieldPriorityAndScore]];
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::outputPixels(const uInt8* from, const uInt8* to)
+{
+  if(!myOutputBuffer || !myRenderingEnabled)
+    return;
+
+  // Clip to the visible part of the frame buffer
+  const uInt8* first = myCurrentFrameBuffer + myFramePointerOffset;
+  const uInt8* last = first + 160 * myFrameHeight;
+  if(from < first)  from = first;
+  if(to > last)     to = last;
+
+  while(from < to)
+  {
+    uInt32 pos = from - first;
+    uInt32 count = 160 - pos % 160;
+    if(count > (uInt32)(to - from))
+      count = to - from;
+
+    uInt8* out = myOutputBuffer + (pos / 160) * myOutputPitch +
+                 (pos % 160) * myOutputBytesPerPixel;
+    if(myOutputBytesPerPixel == 2)
+    {
+      const uInt16* palette = (const uInt16*)myOutputPalette;
+      for(uInt32 i = 0; i < count; ++i)
+        ((uInt16*)out)[i] = palette[from[i]];
+    }
+    else
+    {
+      const uInt32* palette = (const uInt32*)myOutputPalette;
+      for(uInt32 i = 0; i < count; ++i)
+        ((uInt32*)out)[i] = palette[from[i]];
+    }
+    from += count;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::reportScanlines(Int32 lines)
+{
+  if(!myRenderingEnabled)
+    return;
+
+  if(lines > (Int32)myFrameHeight)
+    lines = myFrameHeight;
+  for(; (Int32)myScanlinesReported < lines; ++myScanlinesReported)
+    myScanlineCallback(myScanlinesReported,
+        currentFrameBuffer() + 160 * myScanlinesReported,
+        myScanlineCallbackData);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::updateFrame(Int32 clock)
 {
@@ -885,6 +1344,8 @@ void TIA::updateFrame(Int32 clock)
      (myClockAtLastUpdate >= clock))
     return;
 
+  PROFILE_SCOPE(TIA);
+
   // Truncate the number of cycles to update to the stop display point
   if(clock > myClockStopDisplay)
     clock = myClockStopDisplay;
@@ -938,18 +1399,29 @@ void TIA::updateFrame(Int32 clock)
       if(posChanged)
       {
       }
+
+      // An update that ends where this scanline starts only makes the
+      // changes due at its start; the line is drawn by the next update
+      if(myClockAtLastUpdate == clock)
+        break;
     }
 
+    // Only lines inside the visible window are ever shown, so the others
+    // need no pixels; their collisions are still worked out below.  The
+    // row is the one the frame pointer is in, which is what gets written
+    uInt32 row = (myFramePointer - myCurrentFrameBuffer) / 160;
+    bool render = myRenderingEnabled && (row - myFrameYStart) < myFrameHeight;
+
     // Compute the number of clocks we're going to update
     Int32 clocksToUpdate = 0;
 
     // Remember how many clocks we are from the left side of the screen
     Int32 clocksFromStartOfScanLine = 228 - myClocksToEndOfScanLine;
 
-    // See if we're updating more than the current scanline
-    if(clock > (myClockAtLastUpdate + myClocksToEndOfScanLine))
+    // See if we're updating at least the rest of the current scanline
+    if(clock >= (myClockAtLastUpdate + myClocksToEndOfScanLine))
     {
-      // Yes, we have more than one scanline to update so finish current one
+      // Yes, so finish the current one
       clocksToUpdate = myClocksToEndOfScanLine;
       myClocksToEndOfScanLine = 228;
       myClockAtLastUpdate += clocksToUpdate;
@@ -991,18 +1463,29 @@ void TIA::updateFrame(Int32 clock)
       // See if we're in the vertical blank region
       if(myVBLANK & 0x02)
       {
-        memset(myFramePointer, 0, clocksToUpdate);
+        if(render)
+          memset(myFramePointer, 0, clocksToUpdate);
       }
       // Handle all other possible combinations
       else
       {
-        // Update masks
-        myP0Mask = &TIATables::PxMask[mySuppressP0]
-            [myNUSIZ0 & 0x07][160 - (myPOSP0 & 0xFF)];
-        myP1Mask = &TIATables::PxMask[mySuppressP1]
-            [myNUSIZ1 & 0x07][160 - (myPOSP1 & 0xFF)];
-        myBLMask = &TIATables::BLMask[(myCTRLPF & 0x30) >> 4]
-            [160 - (myPOSBL & 0xFF)];
+        // Update masks, and remember where in the mask rows they start
+        // so the runs of each row can be mapped onto the scanline
+        Int32 p0Offset = 160 - (myPOSP0 & 0xFF);
+        Int32 p1Offset = 160 - (myPOSP1 & 0xFF);
+        Int32 blOffset = 160 - (myPOSBL & 0xFF);
+        Int32 m0Offset = 160 - (myPOSM0 & 0xFF);
+        Int32 m1Offset = 160 - (myPOSM1 & 0xFF);
+        const TIATables::MaskRuns* m0Runs =
+            &TIATables::MxMaskRuns[myNUSIZ0 & 0x07][(myNUSIZ0 & 0x30) >> 4];
+        const TIATables::MaskRuns* m1Runs =
+            &TIATables::MxMaskRuns[myNUSIZ1 & 0x07][(myNUSIZ1 & 0x30) >> 4];
+
+        myP0Mask = pxMaskRow(P0MaskRow, mySuppressP0, myNUSIZ0 & 0x07) +
+            p0Offset;
+        myP1Mask = pxMaskRow(P1MaskRow, mySuppressP1, myNUSIZ1 & 0x07) +
+            p1Offset;
+        myBLMask = blMaskRow((myCTRLPF & 0x30) >> 4) + blOffset;
 
         // TODO - 08-27-2009: Simulate the weird effects of Cosmic Ark and
         // Stay Frosty.  The movement itself is well understood, but there
@@ -1018,22 +1501,26 @@ void TIA::updateFrame(Int32 clock)
             case 3:
               // Stretch this missle so it's 2 pixels wide and shifted one
               // pixel to the left
-              myM0Mask = &TIATables::MxMask[myNUSIZ0 & 0x07]
-                  [((myNUSIZ0 & 0x30) >> 4)|1][160 - ((myPOSM0-1) & 0xFF)];
+              m0Offset = 160 - ((myPOSM0-1) & 0xFF);
+              m0Runs = &TIATables::MxMaskRuns[myNUSIZ0 & 0x07]
+                  [((myNUSIZ0 & 0x30) >> 4)|1];
+              myM0Mask = mxMaskRow(M0MaskRow, myNUSIZ0 & 0x07,
+                  ((myNUSIZ0 & 0x30) >> 4)|1) + m0Offset;
               break;
             case 2:
               // Missle is disabled on this line
+              m0Runs = 0;
               myM0Mask = &TIATables::DisabledMask[0];
               break;
             default:
-              myM0Mask = &TIATables::MxMask[myNUSIZ0 & 0x07]
-                  [(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFF)];
+              myM0Mask = mxMaskRow(M0MaskRow, myNUSIZ0 & 0x07,
+                  (myNUSIZ0 & 0x30) >> 4) + m0Offset;
               break;
           }
         }
         else
-          myM0Mask = &TIATables::MxMask[myNUSIZ0 & 0x07]
-              [(myNUSIZ0 & 0x30) >> 4][160 - (myPOSM0 & 0xFF)];
+          myM0Mask = mxMaskRow(M0MaskRow, myNUSIZ0 & 0x07,
+              (myNUSIZ0 & 0x30) >> 4) + m0Offset;
         if(myHMM1mmr)
         {
           switch(myPOSM1 % 4)
@@ -1041,49 +1528,70 @@ void TIA::updateFrame(Int32 clock)
             case 3:
               // Stretch this missle so it's 2 pixels wide and shifted one
               // pixel to the left
-              myM1Mask = &TIATables::MxMask[myNUSIZ1 & 0x07]
-                  [((myNUSIZ1 & 0x30) >> 4)|1][160 - ((myPOSM1-1) & 0xFF)];
+              m1Offset = 160 - ((myPOSM1-1) & 0xFF);
+              m1Runs = &TIATables::MxMaskRuns[myNUSIZ1 & 0x07]
+                  [((myNUSIZ1 & 0x30) >> 4)|1];
+              myM1Mask = mxMaskRow(M1MaskRow, myNUSIZ1 & 0x07,
+                  ((myNUSIZ1 & 0x30) >> 4)|1) + m1Offset;
               break;
             case 2:
               // Missle is disabled on this line
+              m1Runs = 0;
               myM1Mask = &TIATables::DisabledMask[0];
               break;
             default:
-              myM1Mask = &TIATables::MxMask[myNUSIZ1 & 0x07]
-                  [(myNUSIZ1 & 0x30) >> 4][160 - (myPOSM1 & 0xFF)];
+              myM1Mask = mxMaskRow(M1MaskRow, myNUSIZ1 & 0x07,
+                  (myNUSIZ1 & 0x30) >> 4) + m1Offset;
               break;
           }
         }
         else
-          myM1Mask = &TIATables::MxMask[myNUSIZ1 & 0x07]
-              [(myNUSIZ1 & 0x30) >> 4][160 - (myPOSM1 & 0xFF)];
+          myM1Mask = mxMaskRow(M1MaskRow, myNUSIZ1 & 0x07,
+              (myNUSIZ1 & 0x30) >> 4) + m1Offset;
 
         uInt8 enabledObjects = myEnabledObjects & myDisabledObjects;
         uInt32 hpos = clocksFromStartOfScanLine - HBLANK;
-        for(; myFramePointer < ending; ++myFramePointer, ++hpos)
-        {
-          uInt8 enabled = ((enabledObjects & PFBit) &&
-                           (myPF & myPFMask[hpos])) ? PFBit : 0;
-
-          if((enabledObjects & BLBit) && myBLMask[hpos])
-            enabled |= BLBit;
-
-          if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
-            enabled |= P1Bit;
+        uInt32 hend = hpos + clocksToUpdate;
+        uInt8* line = myFramePointer - hpos;
 
-          if((enabledObjects & M1Bit) && myM1Mask[hpos])
-            enabled |= M1Bit;
-
-          if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
-            enabled |= P0Bit;
-
-          if((enabledObjects & M0Bit) && myM0Mask[hpos])
-            enabled |= M0Bit;
-
-          myCollision |= TIATables::CollisionMask[enabled];
-          *myFramePointer = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
-              [enabled | myPlayfieldPriorityAndScore]];
+        // Collisions are kept up to date even when nothing is drawn
+        if(render)
+        {
+          // Short pieces of a scanline (the kernel wrote to the TIA in the
+          // middle of it) are cheaper to draw pixel by pixel
+          if(hend - hpos < 32)
+            renderPixels(line, hpos, hend, enabledObjects);
+          else
+          {
+            // Collect the pixels where a moving object may be visible; only
+            // those need to be composed one by one, while playfield and
+            // background are drawn in runs
+            uInt16 spans[5 * 8 * 2];
+            uInt32 numSpans = 0;
+            if((enabledObjects & P0Bit) && myCurrentGRP0)
+              numSpans = addObjectSpans(spans, numSpans,
+                  TIATables::PxMaskRuns[mySuppressP0][myNUSIZ0 & 0x07],
+                  p0Offset, hpos, hend);
+            if((enabledObjects & P1Bit) && myCurrentGRP1)
+              numSpans = addObjectSpans(spans, numSpans,
+                  TIATables::PxMaskRuns[mySuppressP1][myNUSIZ1 & 0x07],
+                  p1Offset, hpos, hend);
+            if((enabledObjects & M0Bit) && m0Runs)
+              numSpans = addObjectSpans(spans, numSpans, *m0Runs,
+                  m0Offset, hpos, hend);
+            if((enabledObjects & M1Bit) && m1Runs)
+              numSpans = addObjectSpans(spans, numSpans, *m1Runs,
+                  m1Offset, hpos, hend);
+            if(enabledObjects & BLBit)
+              numSpans = addObjectSpans(spans, numSpans,
+                  TIATables::BLMaskRuns[(myCTRLPF & 0x30) >> 4],
+                  blOffset, hpos, hend);
+
+            renderSpans(line, hpos, hend, enabledObjects, spans, numSpans);
+          }
         }
+
+        recordCollisions(hpos, hend, enabledObjects);
       }
       myFramePointer = ending;
     }
@@ -1093,12 +1601,24 @@ void TIA::updateFrame(Int32 clock)
         (clocksFromStartOfScanLine < (HBLANK + 8)))
     {
       Int32 blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
-      memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
+      if(render)
+        memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
         myHMOVEBlankEnabled = false;
     }
 
+    // Hand each finished scanline to the direct output and the scanline
+    // callback while it is still in the cache; a line ended by WSYNC is
+    // finished by the WSYNC itself
+    if(myClocksToEndOfScanLine == 228)
+    {
+      if(myOutputBuffer)
+        flushOutput();
+      if(myScanlineCallback)
+        reportScanlines((myFramePointer - currentFrameBuffer()) / 160);
+    }
+
 // TODO - this needs to be updated to actually do as the comment suggests
 #if 1
     // See if we're at the end of a scanline
@@ -1120,7 +1640,14 @@ inline void TIA::waitHorizontalSync()
       (myClockWhenFrameStarted / 3)) % 76);
 
   if(cyclesToEndOfLine < 76)
+  {
     mySystem->incrementCycles(cyclesToEndOfLine);
+
+    // Nothing can change while the CPU is halted, so draw the rest of the
+    // scanline now in one go, rather than in pieces when the TIA is next
+    // accessed
+    updateFrame(mySystem->cycles() * 3);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1177,6 +1704,9 @@ inline void TIA::waitHorizontalRSync()
       (myClockWhenFrameStarted / 3)) % 76);
 
   mySystem->incrementCycles(cyclesToEndOfLine-1);
+
+  // As in waitHorizontalSync(), draw up to where the CPU resumes
+  updateFrame(mySystem->cycles() * 3);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1200,8 +1730,13 @@ inline uInt8 TIA::dumpedInputPort(int resistance)
   else
   {
     // Constant here is derived from '1.6 * 0.01e-6 * 228 / 3'
+#ifdef STELLA_FIXED_POINT
+    uInt32 needed = (uInt32)(((uInt64)(resistance * myScanlineCountForLastFrame) *
+        myDumpRate) >> 32);
+#else
     uInt32 needed = (uInt32)
       (1.216e-6 * resistance * myScanlineCountForLastFrame * myFramerate);
+#endif
     if((mySystem->cycles() - myDumpDisabledCycle) > needed)
       return 0x80;
     else
@@ -1222,6 +1757,10 @@ uInt8 TIA::peek(uInt16 addr)
   // valid bits in a TIA read), and selectively enable them
   uInt8 value = 0x3F & (!myTIAPinsDriven ? mySystem->getDataBusState() :
                         mySystem->getDataBusState(0xFF));
+
+  // Collisions are only worked out when one of CXM0P .. CXPPMM is read
+  if((addr & 0x000f) <= CXPPMM)
+    resolveCollisions();
   uInt16 collision = myCollision & (uInt16)myCollisionEnabledMask;
 
   switch(addr & 0x000f)
@@ -1571,15 +2110,14 @@ bool TIA::poke(uInt16 addr, uInt8 value)
         // TODO - update player timing
 
         // Find out under what condition the player is being reset
-        delay = TIATables::PxPosResetWhen[myNUSIZ0 & 7][myPOSP0][newx];
+        delay = TIATables::pxPosResetWhen(myNUSIZ0 & 7, myPOSP0, newx);
 
         switch(delay)
         {
           // Player is being reset during the display of one of its copies
           case 1:
             // TODO - 08-20-2009: determine whether we really need to update
-            // the frame here, and also come up with a way to eliminate the
-            // 200KB PxPosResetWhen table.
+            // the frame here.
             updateFrame(clock + 11);
             mySuppressP0 = 1;
             break;
@@ -1621,15 +2159,14 @@ bool TIA::poke(uInt16 addr, uInt8 value)
         // TODO - update player timing
 
         // Find out under what condition the player is being reset
-        delay = TIATables::PxPosResetWhen[myNUSIZ1 & 7][myPOSP1][newx];
+        delay = TIATables::pxPosResetWhen(myNUSIZ1 & 7, myPOSP1, newx);
 
         switch(delay)
         {
           // Player is being reset during the display of one of its copies
           case 1:
             // TODO - 08-20-2009: determine whether we really need to update
-            // the frame here, and also come up with a way to eliminate the
-            // 200KB PxPosResetWhen table.
+            // the frame here.
             updateFrame(clock + 11);
             mySuppressP1 = 1;
             break;
@@ -2088,6 +2625,7 @@ bool TIA::poke(uInt16 addr, uInt8 value)
     case CXCLR:   // Clear collision latches
     {
       myCollision = 0;
+      myNumCollisionSpans = 0;
       break;
     }
 
@@ -207,6 +207,16 @@ class System : public Serializable
     */  
     uInt8 getDataBusState() const { return myDataBusState; }
 
+#ifdef M6502_BLOCK_CACHE
+    /**
+      Set the data bus to a byte read without going through peek(), as
+      the 6502 does with the code bytes it has decoded in advance.
+
+      @param value  The byte last read
+    */
+    void setDataBusState(uInt8 value) { myDataBusState = value; }
+#endif
+
     /**
       Get the current state of the data bus in the system, taking into
       account that certain bits are in Z-state (undriven).  In those
@@ -236,11 +246,37 @@ class System : public Serializable
 
       @param address  The address from which the value should be loaded
       @param flags    Indicates that this address has the given flags
-                      for type of access (CODE, DATA, GFX, etc)
+                      for type of access (CODE, DATA, GFX, etc); only
+                      taken when the debugger is compiled in
 
       @return The byte at the specified address
     */
-    uInt8 peek(uInt16 address, uInt8 flags = 0);
+#ifdef DEBUGGER_SUPPORT
+    uInt8 peek(uInt16 address, uInt8 flags = 0)
+#else
+    uInt8 peek(uInt16 address)
+#endif
+    {
+      uInt16 page = (address & myAddressMask) >> myPageShift;
+      const PageAccess& access = myPageAccessTable[page];
+
+      // See if this page uses direct accessing or not
+      uInt8 result;
+      if(access.directPeekBase)
+        result = access.directPeekBase[address & myPageMask];
+      else
+      {
+        result = access.device->peek(address);
+#ifdef M6502_BLOCK_CACHE
+        // The device may have switched banks or written to its memory
+        if(myCodeWatch[page] & WatchDevice)
+          deviceAccessed(page);
+#endif
+      }
+
+      myDataBusState = result;
+      return result;
+    }
 
     /**
       Change the byte at the specified address to the given value.
@@ -255,7 +291,37 @@ class System : public Serializable
       @param address  The address where the value should be stored
       @param value    The value to be stored at the address
     */
-    void poke(uInt16 address, uInt8 value);
+    void poke(uInt16 address, uInt8 value)
+    {
+      uInt16 page = (address & myAddressMask) >> myPageShift;
+      const PageAccess& access = myPageAccessTable[page];
+
+      // See if this page uses direct accessing or not
+      if(access.directPokeBase)
+      {
+        // Since we have direct access to this poke, we can dirty its page
+        uInt8* byte = access.directPokeBase + (address & myPageMask);
+#ifdef M6502_BLOCK_CACHE
+        // Decoded code reading the byte only changes with its value
+        if((myCodeWatch[page] & WatchPoke) && *byte != value)
+          codeWritten(page, byte);
+#endif
+        *byte = value;
+        myPageIsDirtyTable[page] = true;
+      }
+      else
+      {
+        // The specific device informs us if the poke succeeded
+        myPageIsDirtyTable[page] = access.device->poke(address, value);
+#ifdef M6502_BLOCK_CACHE
+        // The device may have switched banks or written to its memory
+        if(myCodeWatch[page] & WatchDevice)
+          deviceAccessed(page);
+#endif
+      }
+
+      myDataBusState = value;
+    }
 
     /**
       Lock/unlock the data bus. When the bus is locked, peek() and
@@ -308,14 +374,17 @@ class System : public Serializable
       */
       uInt8* directPokeBase;
 
+#ifdef DEBUGGER_SUPPORT
       /**
         Pointer to a lookup table for marking an address as CODE.  A CODE
         section is defined as any address that appears in the program
         counter.  Currently, this is used by the debugger/disassembler to
         conclusively determine if a section of address space is CODE, even
-        if the disassembler failed to mark it as such.
+        if the disassembler failed to mark it as such.  Only kept when the
+        debugger is compiled in.
       */
       uInt8* codeAccessBase;
+#endif
 
       /**
         Pointer to the device associated with this page or to the system's 
@@ -329,11 +398,13 @@ class System : public Serializable
       */
       PageAccessType type;
 
-      // Constructors
+      // Constructors; 'code' is ignored without the debugger
       PageAccess()
         : directPeekBase(0),
           directPokeBase(0),
+#ifdef DEBUGGER_SUPPORT
           codeAccessBase(0),
+#endif
           device(0),
           type(System::PA_READ) { }
 
@@ -341,9 +412,19 @@ class System : public Serializable
                  PageAccessType access)
         : directPeekBase(peek),
           directPokeBase(poke),
+#ifdef DEBUGGER_SUPPORT
           codeAccessBase(code),
+#endif
           device(dev),
           type(access) { }
+
+      // Set the code-access lookup table; does nothing without the debugger
+      void setCodeAccessBase(uInt8* code)
+      {
+#ifdef DEBUGGER_SUPPORT
+        codeAccessBase = code;
+#endif
+      }
     };
 
     /**
@@ -370,6 +451,40 @@ class System : public Serializable
     */
     System::PageAccessType getPageAccessType(uInt16 addr) const;
 
+#ifdef M6502_BLOCK_CACHE
+    /**
+      Get the generations of the pages.  The generation of a page moves
+      on whenever the code read through it may have changed: when the
+      page is mapped again, or when a write or a device access reaches
+      the memory of a page the 6502 has decoded code from (see
+      watchCode()).
+
+      @return  The generation of each page
+    */
+    const uInt32* pageGenerations() const { return myPageGenerations; }
+
+    /**
+      Tell the system that the 6502 has decoded code read through the
+      given page, so that the writes and device accesses that can change
+      that code move on the generation of the page.  This lasts until
+      the page is mapped again.
+
+      @param page  The page the code was read through
+    */
+    void watchCode(uInt16 page)
+    {
+      if(!(myCodeWatch[page] & WatchCode))
+        addCodePage(page);
+    }
+
+    /**
+      Move on the generation of every page, after the memory of the
+      devices may have changed other than through this system (such as
+      when a state has been loaded).
+    */
+    void codeChanged();
+#endif
+
     /**
       Mark the page containing this address as being dirty.
 
@@ -414,6 +529,30 @@ class System : public Serializable
     */
     string name() const { return "System"; }
 
+  private:
+#ifdef M6502_BLOCK_CACHE
+    /**
+      Start watching the given page for changes to its code.
+    */
+    void addCodePage(uInt16 page);
+
+    /**
+      Called for a direct write changing a byte on a page that may reach
+      code, before the byte is changed.
+
+      @param page  The page written
+      @param byte  The byte of memory written
+    */
+    void codeWritten(uInt16 page, const uInt8* byte);
+
+    /**
+      Called after a device access on a page whose device holds code.
+
+      @param page  The page accessed
+    */
+    void deviceAccessed(uInt16 page);
+#endif
+
   private:
     // Mask to apply to an address before accessing memory
     const uInt16 myAddressMask;
@@ -471,6 +610,25 @@ class System : public Serializable
     // Some parts of the codebase need to act differently in such a case
     bool mySystemInAutodetect;
 
+#ifdef M6502_BLOCK_CACHE
+    // How each page is watched for changes to decoded code: whether code
+    // is read through it, whether direct writes to it can reach code,
+    // and whether accesses to its device can change code
+    enum { WatchCode = 0x01, WatchPoke = 0x02, WatchDevice = 0x04 };
+    uInt8* myCodeWatch;
+
+    // The generation of each page (see pageGenerations())
+    uInt32* myPageGenerations;
+
+    // The pages code is read through, and their number
+    uInt16* myCodePages;
+    uInt16 myNumberOfCodePages;
+
+    // The TIA and 6532 as devices; accessing them never changes code
+    Device* myTIADevice;
+    Device* myM6532Device;
+#endif
+
   private:
     // Copy constructor isn't supported by this class so make it private
     System(const System&);
@@ -169,6 +169,20 @@ class TIA : public Device
     */
     void update();
 
+    /**
+      Like update(), but returns early once the given scanline of the
+      frame has been reached, with the frame buffer (and the direct
+      output) drawn up to the current position.  A frame left unfinished
+      is carried on by the next call of this method or of update().
+      Allows the frontend to read input or show the finished lines before
+      the whole frame has been emulated.
+
+      @param line  The scanline to run until, counted from the start of
+                   the frame
+      @return  True if the frame was finished
+    */
+    bool updateToScanline(uInt32 line);
+
     /**
       Answers the current frame buffer
 
@@ -216,16 +230,99 @@ class TIA : public Device
     void enableColorLoss(bool mode)
       { myColorLossEnabled = myFramerate <= 55 ? mode : false; }
 
+    /**
+      Enables/disables drawing pixels into the frame buffer.  While
+      disabled, the beam, object motion, HMOVE and collisions are still
+      emulated exactly, but the frame buffer keeps its old contents; this
+      is meant for frames nobody will look at (fast-forward, frameskip).
+
+      @param mode  Whether to enable or disable drawing
+    */
+    void enableRendering(bool mode) { myRenderingEnabled = mode; }
+
+    /**
+      Answers whether pixels are currently drawn into the frame buffer.
+    */
+    bool renderingEnabled() const { return myRenderingEnabled; }
+
+    /**
+      Makes the TIA also write the visible frame (the part answered by
+      currentFrameBuffer()) as finished pixels into the given buffer,
+      translating the color indices through the given palette as each
+      piece of a scanline is drawn, instead of leaving the whole frame
+      buffer to be converted once the frame is done.  The color indices
+      are still written to the frame buffer as well, so this moves the
+      conversion rather than removing it.  Whatever the frame doesn't
+      draw (or a dropped frame shown again) is written when it ends, so
+      the buffer always holds what currentFrameBuffer() does.
+
+      @param buffer         The destination (NULL turns direct output off)
+      @param pitch          The distance between two lines in bytes
+      @param bytesPerPixel  2 for a palette of uInt16 (e.g. RGB565),
+                            4 for a palette of uInt32 (e.g. XRGB8888)
+      @param palette        The 256 pixel values of the color indices
+    */
+    void setDirectOutput(void* buffer, uInt32 pitch, uInt32 bytesPerPixel,
+                         const void* palette)
+    {
+      myOutputBuffer = (uInt8*)buffer;
+      myOutputPitch = pitch;
+      myOutputBytesPerPixel = bytesPerPixel;
+      myOutputPalette = palette;
+    }
+
+    /**
+      Receives a line of the visible frame once it has been drawn.
+
+      @param line    The number of the line within the visible frame
+      @param pixels  The 160 color indices of the line
+      @param data    The pointer given to setScanlineCallback()
+    */
+    typedef void (*ScanlineCallback)(uInt32 line, const uInt8* pixels,
+                                     void* data);
+
+    /**
+      Makes the TIA report each line of the visible frame (the part
+      answered by currentFrameBuffer()) as soon as it has been drawn
+      completely, in order, so that a display can start showing a frame
+      while the rest of it is still being emulated.  The lines a frame
+      doesn't reach are reported when it ends; if the frame is then
+      blanked for having too many scanlines, all of its lines are
+      reported again.  Nothing is reported while rendering is disabled.
+
+      @param callback  The function to call (NULL turns reporting off)
+      @param data      Passed on to the callback
+    */
+    void setScanlineCallback(ScanlineCallback callback, void* data)
+    {
+      myScanlineCallback = callback;
+      myScanlineCallbackData = data;
+    }
+
     /**
       Answers whether this TIA runs at NTSC or PAL scanrates,
       based on how many frames of out the total count are PAL frames.
     */
     bool isPAL()
-      { return float(myPALFrameCounter) / myFrameCounter >= (25.0/60.0); }
+    {
+#ifdef STELLA_FIXED_POINT
+      return myFrameCounter > 0 &&
+             (uInt64)myPALFrameCounter * 60 >= (uInt64)myFrameCounter * 25;
+#else
+      return float(myPALFrameCounter) / myFrameCounter >= (25.0/60.0);
+#endif
+    }
 
     uInt64 getMilliSeconds() const {
         uInt64 ntscFrames = myFrameCounter - myPALFrameCounter;
+#ifdef STELLA_FIXED_POINT
+        // 50 / 3 ms per NTSC frame, without a 64-bit division
+        uInt32 ntsc = (uInt32)ntscFrames;
+        return (uInt64)(ntsc / 3) * 50 + (ntsc % 3) * 50 / 3 +
+               (uInt64)myPALFrameCounter * 20;
+#else
         return ntscFrames * (1000.0f/60.0f) + myPALFrameCounter * (1000.0f/50.f);
+#endif
     }
 
     /**
@@ -349,7 +446,108 @@ class TIA : public Device
     // Update the current frame buffer to the specified color clock
     void updateFrame(Int32 clock);
 
-    // Waste cycles until the current scanline is finished
+    // Remember the objects of pixels [hpos, hend) of the current scanline
+    // if they can add to the collision latches
+    void recordCollisions(uInt32 hpos, uInt32 hend, uInt8 enabledObjects);
+
+    // Answers the collision latches including the collisions of all
+    // recorded pieces of scanlines
+    uInt16 collisions() const;
+
+    // Fold the recorded pieces of scanlines into the collision latches
+    void resolveCollisions()
+    {
+      myCollision = collisions();
+      myNumCollisionSpans = 0;
+    }
+
+    // Write the given part of the current frame buffer to the direct
+    // output, as far as it is visible
+    void outputPixels(const uInt8* from, const uInt8* to);
+
+    // Write everything drawn since the last call to the direct output
+    void flushOutput()
+    {
+      outputPixels(myOutputPointer, myFramePointer);
+      myOutputPointer = myFramePointer;
+    }
+
+    // Report the lines of the visible frame up to the given one (exclusive)
+    // to the scanline callback, if not done already
+    void reportScanlines(Int32 lines);
+
+    // The rows of the player, missle and ball mask tables for each
+    // object; with TIA_SMALL_TABLES the rows in use are built on demand
+    enum { P0MaskRow, P1MaskRow, M0MaskRow, M1MaskRow, BLMaskRow };
+
+    const uInt8* pxMaskRow(uInt32 object, uInt32 suppress, uInt32 nusiz)
+    {
+#ifdef TIA_SMALL_TABLES
+      if(useMaskRow(object, (suppress << 3) | nusiz))
+        TIATables::buildPxMaskRow(myMaskRows[object], suppress, nusiz);
+      return myMaskRows[object];
+#else
+      return TIATables::PxMask[suppress][nusiz];
+#endif
+    }
+
+    const uInt8* mxMaskRow(uInt32 object, uInt32 number, uInt32 size)
+    {
+#ifdef TIA_SMALL_TABLES
+      if(useMaskRow(object, (number << 3) | size))
+        TIATables::buildMxMaskRow(myMaskRows[object], number, size);
+      return myMaskRows[object];
+#else
+      return TIATables::MxMask[number][size];
+#endif
+    }
+
+    const uInt8* blMaskRow(uInt32 size)
+    {
+#ifdef TIA_SMALL_TABLES
+      if(useMaskRow(BLMaskRow, size))
+        TIATables::buildBLMaskRow(myMaskRows[BLMaskRow], size);
+      return myMaskRows[BLMaskRow];
+#else
+      return TIATables::BLMask[size];
+#endif
+    }
+
+#ifdef TIA_SMALL_TABLES
+    // Answers whether the row of the given object must be rebuilt to
+    // hold the row with the given id.  Recorded pieces of scanlines may
+    // still point into the old row, so their collisions are worked out
+    // first.
+    bool useMaskRow(uInt32 object, uInt32 id)
+    {
+      if(myMaskRowIds[object] == id)
+        return false;
+
+      if(myNumCollisionSpans)
+        resolveCollisions();
+      myMaskRowIds[object] = id;
+      return true;
+    }
+#endif
+
+    // Draw pixels [hpos, hend) of the current scanline with only the
+    // playfield and background, writing runs of equal color at once
+    void renderPlayfieldSpans(uInt8* line, uInt32 hpos, uInt32 hend,
+                              uInt8 enabledObjects);
+
+    // Draw pixels [hpos, hend) of the current scanline, composing objects
+    // only within the given spans of possibly visible objects (encoded as
+    // (start << 8) | end) and drawing the playfield in runs elsewhere
+    void renderSpans(uInt8* line, uInt32 hpos, uInt32 hend,
+                     uInt8 enabledObjects, uInt16* spans, uInt32 numSpans);
+
+    // Draw pixels [hpos, hend) of the current scanline one at a time,
+    // composing all objects
+    void renderPixels(uInt8* line, uInt32 hpos, uInt32 hend,
+                      uInt8 enabledObjects);
+
+    // Waste cycles until the current scanline is finished, and draw the
+    // rest of it
     void waitHorizontalSync();
 
     // Reset horizontal sync counter
@@ -403,6 +601,23 @@ class TIA : public Device
     // (the exported frame buffer is a vertical 'sliding window' of the actual buffer)
     uInt32 myFramePointerOffset;
 
+    // Destination and format of the direct output; see setDirectOutput()
+    uInt8* myOutputBuffer;
+    uInt32 myOutputPitch;
+    uInt32 myOutputBytesPerPixel;
+    const void* myOutputPalette;
+
+    // Everything in the current frame buffer before this has been written
+    // to the direct output
+    uInt8* myOutputPointer;
+
+    // Receiver of the finished lines of the visible frame, if any
+    ScanlineCallback myScanlineCallback;
+    void* myScanlineCallbackData;
+
+    // Number of lines of the visible frame reported to the callback
+    uInt32 myScanlinesReported;
+
     // Indicates the number of 'colour clocks' offset from the base
     // frame buffer pointer
     // (this is used when loading state files with a 'partial' frame)
@@ -555,6 +770,13 @@ class TIA : public Device
     const uInt8* myBLMask;
     const uInt32* myPFMask;
 
+#ifdef TIA_SMALL_TABLES
+    // The mask table rows currently used by each object, and which rows
+    // they are
+    uInt8 myMaskRows[5][320];
+    uInt32 myMaskRowIds[5];
+#endif
+
     // Audio values; only used by TIADebug
     uInt8 myAUDV0, myAUDV1, myAUDC0, myAUDC1, myAUDF0, myAUDF1;
 
@@ -591,6 +813,10 @@ class TIA : public Device
     // contains an odd number of scanlines.
     bool myColorLossEnabled;
 
+    // Indicates if pixels are drawn into the frame buffer; see
+    // enableRendering()
+    bool myRenderingEnabled;
+
     // Indicates whether we're done with the current frame. poke() clears this
     // when VSYNC is strobed or the max scanlines/frame limit is hit.
     bool myPartialFrameFlag;
@@ -607,9 +833,38 @@ class TIA : public Device
     // The framerate currently in use by the Console
     float myFramerate;
 
+#ifdef STELLA_FIXED_POINT
+    // The paddle capacitor charge rate used by dumpedInputPort(), which is
+    // 1.216e-6 * myFramerate in 0.32 fixed point, kept without computing
+    // the framerate itself
+    uInt32 myDumpRate;
+#endif
+
     // Whether TIA bits/collisions are currently enabled/disabled
     bool myBitsEnabled, myCollisionsEnabled;
 
+    // A piece of a scanline drawn while objects that may collide were
+    // visible; the collisions within it are only worked out once the
+    // game reads a collision register (objects that are off have a zero
+    // graphics value or bit)
+    struct CollisionSpan {
+      const uInt32* pfMask;
+      const uInt8* blMask;
+      const uInt8* p0Mask;
+      const uInt8* m0Mask;
+      const uInt8* p1Mask;
+      const uInt8* m1Mask;
+      uInt32 pf;
+      uInt8 bl, grp0, m0, grp1, m1;
+      uInt8 hpos, hend;
+    };
+
+    // Pieces of scanlines drawn since the collision latches were last
+    // brought up to date
+    enum { kCollisionSpans = 128 };
+    CollisionSpan myCollisionSpans[kCollisionSpans];
+    uInt32 myNumCollisionSpans;
+
   private:
     // Copy constructor isn't supported by this class so make it private
     TIA(const TIA&);
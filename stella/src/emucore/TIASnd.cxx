@@ -25,7 +25,8 @@ TIASound::TIASound(Int32 outputFrequency)
   : myChannelMode(Hardware2Stereo),
     myOutputFrequency(outputFrequency),
     myOutputCounter(0),
-    myVolumePercentage(100)
+    myVolumePercentage(100),
+    myLowPassFactor(0)
 {
   reset();
 }
@@ -56,9 +57,12 @@ void TIASound::reset()
     myP4[chan] = 0;
     myP5[chan] = 0;
     myP9[chan] = 0;
+    myCycleLength[chan] = 0;
+    myCycleIndex[chan] = 0;
   }
 
   myOutputCounter = 0;
+  myLowPass[0] = myLowPass[1] = 0;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -88,6 +92,9 @@ string TIASound::channels(uInt32 hardware, bool stereo)
 void TIASound::set(uInt16 address, uInt8 value)
 {
   int chan = ~address & 0x1;
+  uInt8 audc = myAUDC[chan];
+  bool silent = myAUDV[chan] == 0;
+
   switch(address)
   {
     case 0x15:    // AUDC0
@@ -109,6 +116,10 @@ void TIASound::set(uInt16 address, uInt8 value)
       return;
   }
 
+  // The cycle table only depends on these
+  if(myAUDC[chan] != audc || (myAUDV[chan] == 0) != silent)
+    myCycleLength[chan] = 0;
+
   uInt16 newVal = 0;
 
   // An AUDC value of 0 is a special case
@@ -174,22 +185,70 @@ uInt8 TIASound::get(uInt16 address) const
 void TIASound::volume(uInt32 percent)
 {
   if(percent <= 100)
+  {
     myVolumePercentage = percent;
+    myCycleLength[0] = myCycleLength[1] = 0;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::lowPass(uInt32 factor)
+{
+  if(factor < 0x10000)
+    myLowPassFactor = factor;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIASound::process(Int16* buffer, uInt32 samples)
 {
+  // Take external volume into account
+  Int16 audv0 = (myAUDV[0] * myVolumePercentage) / 100,
+        audv1 = (myAUDV[1] * myVolumePercentage) / 100;
+
+  // At the TIA rate every clock of the generators gives one sample, so
+  // the samples can be created from the cycle tables; each channel on
+  // its own, unless the filter needs them mixed
+  if(myOutputFrequency == 31400 &&
+     (myDivNCnt[0] == 0 || myCycleLength[0] > 0 || buildCycle(0, audv0)) &&
+     (myDivNCnt[1] == 0 || myCycleLength[1] > 0 || buildCycle(1, audv1)))
+  {
+    if(myLowPassFactor)
+    {
+      filterRuns(buffer, samples, audv0, audv1);
+      return;
+    }
+
+    switch(myChannelMode)
+    {
+      case Hardware2Mono:  // mono sampling with 2 hardware channels
+        fillChannel(0, buffer, 2, samples, false, audv0);
+        fillChannel(1, buffer, 2, samples, true, audv1);
+        for(uInt32 i = 0; i < 2 * samples; i += 2)
+          buffer[i + 1] = buffer[i];
+        break;
+
+      case Hardware2Stereo:  // stereo sampling with 2 hardware channels
+        fillChannel(0, buffer, 2, samples, false, audv0);
+        fillChannel(1, buffer + 1, 2, samples, false, audv1);
+        break;
+
+      case Hardware1:  // mono/stereo sampling with only 1 hardware channel
+        fillChannel(0, buffer, 1, samples, false, audv0);
+        fillChannel(1, buffer, 1, samples, true, audv1);
+        break;
+    }
+    return;
+  }
+
+  Int16* start = buffer;
+  uInt32 length = samples;
+
   // Make temporary local copy
   uInt8 audc0 = myAUDC[0], audc1 = myAUDC[1];
   uInt8 p5_0 = myP5[0], p5_1 = myP5[1];
   uInt8 div_n_cnt0 = myDivNCnt[0], div_n_cnt1 = myDivNCnt[1];
   Int16 v0 = myVolume[0], v1 = myVolume[1];
 
-  // Take external volume into account
-  Int16 audv0 = (myAUDV[0] * myVolumePercentage) / 100,
-        audv1 = (myAUDV[1] * myVolumePercentage) / 100;
-
   // Loop until the sample buffer is full
   while(samples > 0)
   {
@@ -200,70 +259,8 @@ void TIASound::process(Int16* buffer, uInt32 samples)
     }
     else if (div_n_cnt0 == 1)
     {
-      int prev_bit5 = Bit5[p5_0];
       div_n_cnt0 = myDivNMax[0];
-
-      // The P5 counter has multiple uses, so we increment it here
-      p5_0++;
-      if (p5_0 == POLY5_SIZE)
-        p5_0 = 0;
-
-      // Check clock modifier for clock tick
-      if ((audc0 & 0x02) == 0 ||
-         ((audc0 & 0x01) == 0 && Div31[p5_0]) ||
-         ((audc0 & 0x01) == 1 && Bit5[p5_0]) ||
-         ((audc0 & 0x0f) == POLY5_DIV3 && Bit5[p5_0] != prev_bit5))
-      {
-        if (audc0 & 0x04)       // Pure modified clock selected
-        {
-          if ((audc0 & 0x0f) == POLY5_DIV3) // POLY5 -> DIV3 mode
-          {
-            if ( Bit5[p5_0] != prev_bit5 )
-            {
-              myDiv3Cnt[0]--;
-              if ( !myDiv3Cnt[0] )
-              {
-                myDiv3Cnt[0] = 3;
-                v0 = v0 ? 0 : audv0;
-              }
-            }
-          }
-          else
-          {
-            // If the output was set turn it off, else turn it on
-            v0 = v0 ? 0 : audv0;
-          }
-        }
-        else if (audc0 & 0x08)  // Check for p5/p9
-        {
-          if (audc0 == POLY9)   // Check for poly9
-          {
-            // Increase the poly9 counter
-            myP9[0]++;
-            if (myP9[0] == POLY9_SIZE)
-              myP9[0] = 0;
-
-            v0 = Bit9[myP9[0]] ? audv0 : 0;
-          }
-          else if ( audc0 & 0x02 )
-          {
-            v0 = (v0 || audc0 & 0x01) ? 0 : audv0;
-          }
-          else  // Must be poly5
-          {
-            v0 = Bit5[p5_0] ? audv0 : 0;
-          }
-        }
-        else  // Poly4 is the only remaining option
-        {
-          // Increase the poly4 counter
-          myP4[0]++;
-          if (myP4[0] == POLY4_SIZE)
-            myP4[0] = 0;
-
-          v0 = Bit4[myP4[0]] ? audv0 : 0;
-        }
-      }
+      clock(audc0, p5_0, myP4[0], myP9[0], myDiv3Cnt[0], v0, audv0);
     }
 
     // Process channel 1
@@ -273,71 +270,8 @@ void TIASound::process(Int16* buffer, uInt32 samples)
     }
     else if (div_n_cnt1 == 1)
     {
-      int prev_bit5 = Bit5[p5_1];
-
       div_n_cnt1 = myDivNMax[1];
-
-      // The P5 counter has multiple uses, so we increment it here
-      p5_1++;
-      if (p5_1 == POLY5_SIZE)
-        p5_1 = 0;
-
-      // Check clock modifier for clock tick
-      if ((audc1 & 0x02) == 0 ||
-         ((audc1 & 0x01) == 0 && Div31[p5_1]) ||
-         ((audc1 & 0x01) == 1 && Bit5[p5_1]) ||
-         ((audc1 & 0x0f) == POLY5_DIV3 && Bit5[p5_1] != prev_bit5))
-      {
-        if (audc1 & 0x04)       // Pure modified clock selected
-        {
-          if ((audc1 & 0x0f) == POLY5_DIV3)   // POLY5 -> DIV3 mode
-          {
-            if ( Bit5[p5_1] != prev_bit5 )
-            {
-              myDiv3Cnt[1]--;
-              if ( ! myDiv3Cnt[1] )
-              {
-                myDiv3Cnt[1] = 3;
-                v1 = v1 ? 0 : audv1;
-              }
-            }
-          }
-          else
-          {
-            // If the output was set turn it off, else turn it on
-            v1 = v1 ? 0 : audv1;
-          }
-        }
-        else if (audc1 & 0x08)  // Check for p5/p9
-        {
-          if (audc1 == POLY9)   // Check for poly9
-          {
-            // Increase the poly9 counter
-            myP9[1]++;
-            if (myP9[1] == POLY9_SIZE)
-              myP9[1] = 0;
-
-            v1 = Bit9[myP9[1]] ? audv1 : 0;
-          }
-          else if ( audc1 & 0x02 )
-          {
-            v1 = (v1 || audc1 & 0x01) ? 0 : audv1;
-          }
-          else  // Must be poly5
-          {
-            v1 = Bit5[p5_1] ? audv1 : 0;
-          }
-        }
-        else  // Poly4 is the only remaining option
-        {
-          // Increase the poly4 counter
-          myP4[1]++;
-          if (myP4[1] == POLY4_SIZE)
-            myP4[1] = 0;
-
-          v1 = Bit4[myP4[1]] ? audv1 : 0;
-        }
-      }
+      clock(audc1, p5_1, myP4[1], myP9[1], myDiv3Cnt[1], v1, audv1);
     }
 
     myOutputCounter += myOutputFrequency;
@@ -383,6 +317,344 @@ void TIASound::process(Int16* buffer, uInt32 samples)
   myVolume[1] = v1;
   myDivNCnt[0] = div_n_cnt0;
   myDivNCnt[1] = div_n_cnt1;
+
+  // The generators have moved on without the cycle tables
+  myCycleLength[0] = myCycleLength[1] = 0;
+
+  if(myLowPassFactor)
+    filter(start, length);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline bool TIASound::clock(uInt8 audc, uInt8& p5, uInt8& p4, uInt16& p9,
+                            uInt8& div3, Int16& v, Int16 audv) const
+{
+  int prev_bit5 = Bit5[p5];
+
+  // The P5 counter has multiple uses, so we increment it here
+  p5++;
+  if (p5 == POLY5_SIZE)
+    p5 = 0;
+
+  // Check clock modifier for clock tick
+  if ((audc & 0x02) == 0 ||
+     ((audc & 0x01) == 0 && Div31[p5]) ||
+     ((audc & 0x01) == 1 && Bit5[p5]) ||
+     ((audc & 0x0f) == POLY5_DIV3 && Bit5[p5] != prev_bit5))
+  {
+    if (audc & 0x04)       // Pure modified clock selected
+    {
+      if ((audc & 0x0f) == POLY5_DIV3) // POLY5 -> DIV3 mode
+      {
+        if ( Bit5[p5] != prev_bit5 )
+        {
+          div3--;
+          if ( !div3 )
+          {
+            div3 = 3;
+            v = v ? 0 : audv;
+            return true;
+          }
+        }
+        return false;
+      }
+      else
+      {
+        // If the output was set turn it off, else turn it on
+        v = v ? 0 : audv;
+      }
+    }
+    else if (audc & 0x08)  // Check for p5/p9
+    {
+      if (audc == POLY9)   // Check for poly9
+      {
+        // Increase the poly9 counter
+        p9++;
+        if (p9 == POLY9_SIZE)
+          p9 = 0;
+
+        v = Bit9[p9] ? audv : 0;
+      }
+      else if ( audc & 0x02 )
+      {
+        v = (v || audc & 0x01) ? 0 : audv;
+      }
+      else  // Must be poly5
+      {
+        v = Bit5[p5] ? audv : 0;
+      }
+    }
+    else  // Poly4 is the only remaining option
+    {
+      // Increase the poly4 counter
+      p4++;
+      if (p4 == POLY4_SIZE)
+        p4 = 0;
+
+      v = Bit4[p4] ? audv : 0;
+    }
+    return true;
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt16 TIASound::cycleState(uInt8 audc, uInt8 p4, uInt16 p9,
+                                   uInt8 div3) const
+{
+  // Only one of the POLY4, POLY9 and div 3 counters is used by a mode
+  if(audc == POLY9)               return p9;
+  else if(audc == POLY5_DIV3)     return div3;
+  else if((audc & 0x0c) == 0)     return p4;
+  else                            return 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIASound::buildCycle(uInt32 chan, Int16 audv)
+{
+  uInt8 audc = myAUDC[chan];
+  uInt8 p5 = myP5[chan], p4 = myP4[chan], div3 = myDiv3Cnt[chan];
+  uInt16 p9 = myP9[chan];
+
+  // The POLY5 is clocked along with every mode, but only matters to the
+  // period of those that use it for their clock or output
+  bool usesP5 = (audc & 0x02) || audc == POLY5;
+
+  // The output of the pure modes toggles, so it is part of the state;
+  // the other modes overwrite it.  Until the channel is clocked the
+  // output may still be at an old volume, so only whether it is set
+  // counts (when the volume is zero, it will never be set again)
+  bool toggles = (audc & 0x04) || audc == DIV31_POLY5;
+  Int16 v = myVolume[chan] ? audv : 0;
+  uInt16 mask = CYCLE_AUX_MASK | (toggles ? CYCLE_OUTPUT : 0);
+  uInt16 start = cycleState(audc, p4, p9, div3) | (v ? CYCLE_OUTPUT : 0);
+  uInt8 startP5 = p5;
+
+  for(uInt32 i = 1; i <= CYCLE_SIZE; ++i)
+  {
+    bool set = clock(audc, p5, p4, p9, div3, v, audv);
+    uInt16 state = cycleState(audc, p4, p9, div3) |
+                   (set ? CYCLE_SET : 0) | (v ? CYCLE_OUTPUT : 0);
+
+    // Back at the start; the clock into it becomes the first entry
+    if((state & mask) == (start & mask) && (!usesP5 || p5 == startP5))
+    {
+      myCycle[chan][0] = state;
+      myCycleLength[chan] = i;
+      myCycleIndex[chan] = 0;
+      return true;
+    }
+    if(i < CYCLE_SIZE)
+      myCycle[chan][i] = state;
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::fillChannel(uInt32 chan, Int16* buffer, uInt32 stride,
+                           uInt32 samples, bool add, Int16 audv)
+{
+  uInt8 div_n_cnt = myDivNCnt[chan];
+  Int16 v = myVolume[chan];
+
+  // Samples left before the next clock of the channel
+  uInt32 next = div_n_cnt > 0 ? div_n_cnt - 1 : samples;
+  uInt32 index = myCycleIndex[chan];
+  uInt8 p5 = myP5[chan];
+
+  for(;;)
+  {
+    uInt32 run = next < samples ? next : samples;
+    if(add)
+      for(uInt32 i = 0; i < run; ++i, buffer += stride)
+        *buffer += v;
+    else
+      for(uInt32 i = 0; i < run; ++i, buffer += stride)
+        *buffer = v;
+
+    samples -= run;
+    next -= run;
+    if(samples == 0)
+      break;
+
+    // Clock the channel; the output is held until the following clock
+    if(++p5 == POLY5_SIZE)
+      p5 = 0;
+    if(++index == myCycleLength[chan])
+      index = 0;
+    uInt16 state = myCycle[chan][index];
+    if(state & CYCLE_SET)
+      v = (state & CYCLE_OUTPUT) ? audv : 0;
+    next = myDivNMax[chan];
+  }
+
+  myVolume[chan] = v;
+  if(div_n_cnt > 0)
+  {
+    myDivNCnt[chan] = next + 1;
+    myCycleIndex[chan] = index;
+
+    // Leave the generator in the state it has reached
+    uInt8 audc = myAUDC[chan];
+    uInt16 state = myCycle[chan][index];
+    uInt16 aux = state & CYCLE_AUX_MASK;
+    myP5[chan] = p5;
+    if(audc == POLY9)               myP9[chan] = aux;
+    else if(audc == POLY5_DIV3)     myDiv3Cnt[chan] = aux;
+    else if((audc & 0x0c) == 0)     myP4[chan] = aux;
+  }
+}
+
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::filterRuns(Int16* buffer, uInt32 samples,
+                          Int16 audv0, Int16 audv1)
+{
+  const Int16 audv[2] = { audv0, audv1 };
+  Int16 v[2] = { myVolume[0], myVolume[1] };
+  uInt8 p5[2] = { myP5[0], myP5[1] };
+  uInt32 index[2] = { myCycleIndex[0], myCycleIndex[1] };
+
+  // Samples left before the next clock of each channel (a channel that
+  // isn't clocked never gets there)
+  uInt32 next[2];
+  for(int chan = 0; chan <= 1; ++chan)
+    next[chan] = myDivNCnt[chan] > 0 ? myDivNCnt[chan] - 1 : ~0u;
+
+  for(;;)
+  {
+    uInt32 run = samples;
+    if(next[0] < run)  run = next[0];
+    if(next[1] < run)  run = next[1];
+
+    buffer = filterRun(buffer, run, v[0], v[1]);
+    samples -= run;
+    next[0] -= run;
+    next[1] -= run;
+    if(samples == 0)
+      break;
+
+    // Clock the channels; their outputs are held until the following
+    // clock
+    for(int chan = 0; chan <= 1; ++chan)
+    {
+      if(next[chan] > 0)
+        continue;
+
+      if(++p5[chan] == POLY5_SIZE)
+        p5[chan] = 0;
+      if(++index[chan] == myCycleLength[chan])
+        index[chan] = 0;
+      uInt16 state = myCycle[chan][index[chan]];
+      if(state & CYCLE_SET)
+        v[chan] = (state & CYCLE_OUTPUT) ? audv[chan] : 0;
+      next[chan] = myDivNMax[chan];
+    }
+  }
+
+  for(int chan = 0; chan <= 1; ++chan)
+  {
+    myVolume[chan] = v[chan];
+    if(myDivNCnt[chan] == 0)
+      continue;
+
+    myDivNCnt[chan] = next[chan] + 1;
+    myCycleIndex[chan] = index[chan];
+
+    // Leave the generator in the state it has reached
+    uInt8 audc = myAUDC[chan];
+    uInt16 aux = myCycle[chan][index[chan]] & CYCLE_AUX_MASK;
+    myP5[chan] = p5[chan];
+    if(audc == POLY9)               myP9[chan] = aux;
+    else if(audc == POLY5_DIV3)     myDiv3Cnt[chan] = aux;
+    else if((audc & 0x0c) == 0)     myP4[chan] = aux;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline Int16* TIASound::filterRun(Int16* buffer, uInt32 run, Int16 v0, Int16 v1)
+{
+  // The output approaches the levels of the run until it stops
+  // changing, after which the rest of the run is plain copies
+  const Int32 factor_a = myLowPassFactor, factor_b = 0x10000 - factor_a;
+
+  if(myChannelMode == Hardware2Stereo)
+  {
+    Int32 left = myLowPass[0], right = myLowPass[1];
+    while(run > 0)
+    {
+      Int32 last_left = left, last_right = right;
+      left  = (left  * factor_a + v0 * factor_b) >> 16;
+      right = (right * factor_a + v1 * factor_b) >> 16;
+      *(buffer++) = (Int16)left;
+      *(buffer++) = (Int16)right;
+      run--;
+      if(left == last_left && right == last_right)
+        break;
+    }
+    myLowPass[0] = left;
+    myLowPass[1] = right;
+
+    for(uInt32 i = 0; i < run; ++i, buffer += 2)
+    {
+      buffer[0] = (Int16)left;
+      buffer[1] = (Int16)right;
+    }
+  }
+  else
+  {
+    Int16 byte = v0 + v1;
+    uInt32 channels = myChannelMode == Hardware2Mono ? 2 : 1;
+
+    Int32 low_pass = myLowPass[0];
+    while(run > 0)
+    {
+      Int32 last = low_pass;
+      low_pass = (low_pass * factor_a + byte * factor_b) >> 16;
+      *(buffer++) = (Int16)low_pass;
+      if(channels == 2)
+        *(buffer++) = (Int16)low_pass;
+      run--;
+      if(low_pass == last)
+        break;
+    }
+    myLowPass[0] = low_pass;
+
+    for(uInt32 i = 0; i < channels * run; ++i)
+      *(buffer++) = (Int16)low_pass;
+  }
+  return buffer;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIASound::filter(Int16* buffer, uInt32 samples)
+{
+  const Int32 factor_a = myLowPassFactor, factor_b = 0x10000 - factor_a;
+
+  if(myChannelMode == Hardware1)
+  {
+    for(uInt32 i = 0; i < samples; ++i)
+    {
+      myLowPass[0] = (myLowPass[0] * factor_a + buffer[i] * factor_b) >> 16;
+      buffer[i] = (Int16)myLowPass[0];
+    }
+  }
+  else
+  {
+    // Both channels of a mono sample are the same, so their outputs are
+    // too
+    uInt32 channels = myChannelMode == Hardware2Stereo ? 2 : 1;
+    for(uInt32 i = 0; i < 2 * samples; i += 2)
+    {
+      for(uInt32 c = 0; c < channels; ++c)
+      {
+        myLowPass[c] = (myLowPass[c] * factor_a + buffer[i + c] * factor_b) >> 16;
+        buffer[i + c] = (Int16)myLowPass[c];
+      }
+      if(channels == 1)
+        buffer[i + 1] = buffer[i];
+    }
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
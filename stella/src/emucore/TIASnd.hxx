@@ -99,9 +99,80 @@ class TIASound
     */
     void volume(uInt32 percent);
 
+    /**
+      Set the single-pole low-pass filter applied to the samples as they
+      are created; each sample moves the output by (0x10000 - factor) /
+      0x10000 towards the unfiltered level
+
+      @param factor  The filter factor in 16.16 fixed point (0 for none)
+    */
+    void lowPass(uInt32 factor);
+
   private:
     void polyInit(uInt8* poly, int size, int f0, int f1);
 
+    /**
+      Clock the waveform generator of a channel once (every time its
+      divide by n counter runs out).
+
+      @return  True if the output of the channel was set
+    */
+    bool clock(uInt8 audc, uInt8& p5, uInt8& p4, uInt16& p9, uInt8& div3,
+               Int16& v, Int16 audv) const;
+
+    /**
+      Answers the position of the counter used by the AUDC mode, as kept
+      in a cycle table entry.
+    */
+    uInt16 cycleState(uInt8 audc, uInt8 p4, uInt16 p9, uInt8 div3) const;
+
+    /**
+      Record the waveform generator states of a channel for one period,
+      starting at its current state.
+
+      @return  True if the period fits into the cycle table
+    */
+    bool buildCycle(uInt32 chan, Int16 audv);
+
+    /**
+      Generate the samples of one channel from its cycle table.  Between
+      two clocks of the channel the output can't change, so each run of
+      equal samples is filled at once.
+
+      @param chan     The channel
+      @param buffer   The location of the first sample
+      @param stride   The distance between two samples of the channel
+      @param samples  The number of samples to generate
+      @param add      Add to the samples in the buffer instead of storing
+      @param audv     The volume of the channel
+    */
+    void fillChannel(uInt32 chan, Int16* buffer, uInt32 stride,
+                     uInt32 samples, bool add, Int16 audv);
+
+    /**
+      Generate filtered samples from the cycle tables of both channels,
+      in a single pass.  Between two clocks of either channel the mixed
+      output can't change, so it is filtered a run at a time.
+
+      @param buffer   The location to store generated samples
+      @param samples  The number of samples to generate
+      @param audv0    The volume of channel 0
+      @param audv1    The volume of channel 1
+    */
+    void filterRuns(Int16* buffer, uInt32 samples, Int16 audv0, Int16 audv1);
+
+    /**
+      Store a filtered run of samples with the given channel outputs.
+
+      @return  The location after the run
+    */
+    Int16* filterRun(Int16* buffer, uInt32 run, Int16 v0, Int16 v1);
+
+    /**
+      Apply the low-pass filter to samples already in the buffer.
+    */
+    void filter(Int16* buffer, uInt32 samples);
+
   private:
     // Definitions for AUDCx (15, 16)
     enum AUDCxRegister
@@ -129,6 +200,7 @@ class TIASound
       POLY5_SIZE = 0x001f,
       POLY9_SIZE = 0x01ff,
       DIV3_MASK  = 0x0c,
+      CYCLE_SIZE = 0x0200,  // longest period of a channel, in clocks
       AUDV_SHIFT = 10     // shift 2 positions for AUDV,
                           // then another 8 for 16-bit sound
     };
@@ -155,11 +227,34 @@ class TIASound
     uInt8 myDivNMax[2]; // Divide by n maximum, one for each channel
     uInt8 myDiv3Cnt[2]; // Div 3 counter, used for POLY5_DIV3 mode
 
+    /*
+      The states of each channel's waveform generator over one period,
+      so that steady tones are generated without clocking it sample by
+      sample.  An entry holds the position of the POLY4, POLY9 or div 3
+      counter used by the AUDC mode, whether the clock into that state
+      set the output, and the output bit; the POLY5 simply moves on with
+      every clock.  The table depends only on the AUDC value and on
+      whether the volume is zero, and is rebuilt when either changes.
+    */
+    enum {
+      CYCLE_AUX_MASK  = 0x01ff,
+      CYCLE_SET       = 0x4000,
+      CYCLE_OUTPUT    = 0x8000
+    };
+    uInt16 myCycle[2][CYCLE_SIZE];
+    uInt32 myCycleLength[2];  // Length of the period (0 if not built)
+    uInt32 myCycleIndex[2];   // Entry of the current state
+
     ChannelMode myChannelMode;
     Int32  myOutputFrequency;
     Int32  myOutputCounter;
     uInt32 myVolumePercentage;
 
+    // The low-pass filter factor (0 when off), and its output for the
+    // left and right (or only) channel
+    Int32 myLowPassFactor;
+    Int32 myLowPass[2];
+
     /*
       Initialize the bit patterns for the polynomials (at runtime).
 
@@ -132,41 +132,48 @@ enum TIARegister {
   TIA state.  For code organization, it's better to place that functionality
   here.
 
+  The computed tables are constant; they are generated by
+  tools/gen_tiatables.cxx into TIATablesData.cxx ("make tiatables").
+
   @author  Stephen Anthony
   @version $Id: TIATables.hxx 2838 2014-01-17 23:34:03Z stephena $
 */
 class TIATables
 {
   public:
-    /**
-      Compute all static tables used by the TIA
-    */
-    static void computeAllTables();
-
+#ifndef TIA_SMALL_TABLES
     // Player mask table
     // [suppress mode][nusiz][pixel]
-    static uInt8 PxMask[2][8][320];
+    static const uInt8 PxMask[2][8][320];
 
     // Missle mask table (entries are true or false)
     // [number][size][pixel]
     // There are actually only 4 possible size combinations on a real system
     // The fifth size is used for simulating the starfield effect in
     // Cosmic Ark and Stay Frosty
-    static uInt8 MxMask[8][5][320];
+    static const uInt8 MxMask[8][5][320];
 
     // Ball mask table (entries are true or false)
     // [size][pixel]
-    static uInt8 BLMask[4][320];
+    static const uInt8 BLMask[4][320];
+#endif
+
+    // Compute one row of the player, missle and ball mask tables; when
+    // built with TIA_SMALL_TABLES the tables don't exist, and the TIA
+    // builds the rows it currently uses itself
+    static void buildPxMaskRow(uInt8* row, uInt32 suppress, uInt32 nusiz);
+    static void buildMxMaskRow(uInt8* row, uInt32 number, uInt32 size);
+    static void buildBLMaskRow(uInt8* row, uInt32 size);
 
     // Playfield mask table for reflected and non-reflected playfields
     // [reflect, pixel]
-    static uInt32 PFMask[2][160];
+    static const uInt32 PFMask[2][160];
 
     // A mask table which can be used when an object is disabled
-    static uInt8 DisabledMask[640];
+    static const uInt8 DisabledMask[640];
 
     // Used to set the collision register to the correct value
-    static uInt16 CollisionMask[64];
+    static const uInt16 CollisionMask[64];
 
     // Indicates the update delay associated with poking at a TIA address
     static const Int16 PokeDelay[64];
@@ -181,33 +188,30 @@ class TIATables
     static const bool HMOVEBlankEnableCycles[76];
 
     // Used to reflect a players graphics
-    static uInt8 GRPReflect[256];
-
-    // Indicates if player is being reset during delay, display or other times
-    // [nusiz][old pixel][new pixel]
-    static Int8 PxPosResetWhen[8][160][160];
-
-  private:
-    // Compute the collision decode table
-    static void buildCollisionMaskTable();
-
-    // Compute the player mask table
-    static void buildPxMaskTable();
-
-    // Compute the missle mask table
-    static void buildMxMaskTable();
-
-    // Compute the ball mask table
-    static void buildBLMaskTable();
-
-    // Compute playfield mask table
-    static void buildPFMaskTable();
-
-    // Compute the player reflect table
-    static void buildGRPReflectTable();
-
-    // Compute the player position reset when table
-    static void buildPxPosResetWhenTable();
+    static const uInt8 GRPReflect[256];
+
+    // Indicates if player is being reset during delay (-1), display (1)
+    // or other times (0)
+    static Int8 pxPosResetWhen(uInt32 nusiz, uInt32 oldx, uInt32 newx);
+
+    // The copies of a player or missle for each nusiz, as a bit for each
+    // copy that starts at a multiple of 16 pixels
+    static const uInt8 NUSIZCopies[8];
+
+    // Runs of non-zero entries in the first 160 entries of one row of a
+    // mask table (the rest of the row repeats them), as pairs of
+    // [start, end) row indices; used by the TIA to find the pixels an
+    // object can possibly cover without testing every pixel
+    struct MaskRuns {
+      uInt32 count;
+      uInt16 start[8];
+      uInt16 end[8];
+    };
+
+    // Runs for the rows of PxMask, MxMask and BLMask
+    static const MaskRuns PxMaskRuns[2][8];
+    static const MaskRuns MxMaskRuns[8][5];
+    static const MaskRuns BLMaskRuns[4];
 };
 
 #endif
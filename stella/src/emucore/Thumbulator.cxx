@@ -28,6 +28,7 @@
 
 #include "bspf.hxx"
 #include "Base.hxx"
+#include "Profiler.hxx"
 #include "Thumbulator.hxx"
 using namespace Common;
 
@@ -47,6 +48,8 @@ Thumbulator::~Thumbulator()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Thumbulator::run( void )
 {
+  PROFILE_SCOPE(ARM);
+
   reset();
   for(;;)
   {
@@ -0,0 +1,391 @@
+/* Golden frame/audio hash regression test for the Stella 2014 core.
+ *
+ * Runs one ROM for a fixed number of frames with a scripted joypad (or
+ * paddles) and records, for every frame, a hash of the TIA frame buffer
+ * (TIA::currentFrameBuffer()), of the converted video frame handed to the
+ * frontend and of the audio samples produced for that frame.  The hashes
+ * are compared against a checked-in golden file, or written to it with -u.
+ * The lines reported by the TIA's scanline callback are also checked
+ * against the finished frame buffer, and so is the video the TIA writes
+ * directly into the frontend's buffer with stella2014_direct_video; each
+ * line of it must be done by the time the line is reported.  When
+ * the frame is run a scanline at a time, each line must be reported
+ * before the CPU runs past the line after it.  When the input is read
+ * again during the frame, each read must come at the scanline asked for.
+ *
+ * Usage: stella2014_regress [-u] [-p] [-o key=value]... rom frames golden
+ *
+ * test/run_tests.sh runs every entry of test/corpus.txt.
+ */
+
+#include "../libretro.cxx"
+#include "../tools/headless.h"
+
+#include <string>
+
+/* 64-bit FNV-1a */
+#define REGRESS_HASH_INIT 0xcbf29ce484222325ULL
+
+static uint64_t regress_hash(uint64_t hash, const void *data, size_t size)
+{
+   const uint8_t *p = (const uint8_t*)data;
+   while (size--)
+   {
+      hash ^= *p++;
+      hash *= 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+static uint64_t regress_video_hash;
+static uint64_t regress_audio_hash;
+static const void *regress_video_data;
+
+static void regress_video(const void *data, unsigned width, unsigned height, size_t pitch)
+{
+   const uint8_t *line = (const uint8_t*)data;
+   unsigned y;
+
+   regress_video_data = data;
+   regress_video_hash = REGRESS_HASH_INIT;
+   for (y = 0; y < height; y++, line += pitch)
+      regress_video_hash = regress_hash(regress_video_hash, line, width * framePixelBytes);
+}
+
+static size_t regress_audio_batch(const int16_t *data, size_t frames)
+{
+   regress_audio_hash = regress_hash(regress_audio_hash, data, frames * 2 * sizeof(int16_t));
+   return frames;
+}
+
+/* A line of the direct video output must hold the palette conversion of
+ * the TIA's pixels */
+static bool regress_direct_line_matches(uInt32 line, const uInt8 *pixels)
+{
+   const uint8_t *palette = (const uint8_t*)get_output_palette();
+   const uint8_t *out     = frameBuffer + line * 160 * framePixelBytes;
+   unsigned i;
+
+   for (i = 0; i < 160; i++, out += framePixelBytes)
+      if (memcmp(out, palette + pixels[i] * framePixelBytes, framePixelBytes))
+         return false;
+   return true;
+}
+
+/* Hash of the lines reported by the scanline callback for the current
+ * frame, which must add up to the TIA frame buffer, and the lines that
+ * were reported only after the CPU had gone past the next one */
+static uint64_t regress_lines_hash;
+static unsigned regress_lines;
+static unsigned regress_late_lines;
+static unsigned regress_unconverted_lines;
+
+static void regress_scanline(uInt32 line, const uInt8 *pixels, void *data)
+{
+   TIA& tia = console->tia();
+
+   /* A frame that is dropped for ending too early starts over */
+   if (line == 0)
+   {
+      regress_lines_hash = REGRESS_HASH_INIT;
+      regress_lines      = 0;
+   }
+   if (line == regress_lines)
+   {
+      regress_lines_hash = regress_hash(regress_lines_hash, pixels, 160);
+      regress_lines++;
+      /* Run a line at a time, the TIA is drawn up to each line as the
+       * CPU reaches it, so nothing holds the line back once the CPU is
+       * past the one after it */
+      if (input_poll_lines == 1 && tia.partialFrame() &&
+          tia.scanlines() > tia.ystart() + line + 1)
+         regress_late_lines++;
+      /* The direct output of a line is converted before it is reported */
+      if (direct_video && !regress_direct_line_matches(line, pixels))
+         regress_unconverted_lines++;
+   }
+}
+
+/* Input polls made in the middle of a frame, and those that came later
+ * than one scanline after the one they were due at */
+static unsigned regress_polls;
+static unsigned regress_late_polls;
+
+static void regress_input_poll(void)
+{
+   TIA& tia = console->tia();
+
+   if (!tia.partialFrame())
+      return;
+   regress_polls++;
+   if (tia.scanlines() > regress_polls * input_poll_lines + 1)
+      regress_late_polls++;
+}
+
+/* The direct video output must hold what the palette conversion of the
+ * frame buffer would give */
+static bool regress_direct_video_matches(TIA& tia)
+{
+   const uint8_t *pixels  = tia.currentFrameBuffer();
+   const uint8_t *palette = (const uint8_t*)get_output_palette();
+   const uint8_t *out     = (const uint8_t*)regress_video_data;
+   unsigned i;
+
+   for (i = 0; i < tia.width() * tia.height(); i++, out += framePixelBytes)
+      if (memcmp(out, palette + pixels[i] * framePixelBytes, framePixelBytes))
+         return false;
+   return true;
+}
+
+/* Joypad script: every 24 frames the next entry is held on port 0, and
+ * its mirror image on port 1 */
+static uint16_t regress_input(unsigned frame)
+{
+#define PAD(b) (1 << RETRO_DEVICE_ID_JOYPAD_##b)
+   static const uint16_t script[] = {
+      0,
+      PAD(RIGHT),
+      PAD(RIGHT) | PAD(B),
+      PAD(DOWN),
+      PAD(DOWN) | PAD(LEFT),
+      PAD(B),
+      PAD(LEFT),
+      PAD(UP) | PAD(B),
+      PAD(START),
+      PAD(UP),
+      PAD(SELECT),
+      PAD(RIGHT) | PAD(UP),
+   };
+#undef PAD
+   return script[(frame / 24) % (sizeof(script) / sizeof(script[0]))];
+}
+
+/* Paddle script: each paddle of port 0 sweeps the whole range of the
+ * Stelladaptor axis and back every 200 frames, the second one 50 frames
+ * behind the first */
+static int16_t regress_paddle(unsigned frame)
+{
+   int step = frame % 200;
+   if (step >= 100)
+      step = 200 - step;
+   return (int16_t)(32767 - step * 655);
+}
+
+/* Makes the left controller of the ROM a pair of paddles, as its entry
+ * in the properties database would */
+static bool regress_use_paddles(const char *path)
+{
+   std::vector<uint8_t> data;
+   Properties props;
+
+   if (!headless_load_file(path, data))
+      return false;
+   props.set(Cartridge_MD5, MD5(&data[0], (uInt32)data.size()));
+   props.set(Controller_Left, "PADDLES");
+   osystem.propSet().insert(props, false);
+   return true;
+}
+
+static void regress_usage(const char *argv0)
+{
+   fprintf(stderr,
+         "Usage: %s [-u] [-p] [-o key=value]... rom frames golden\n"
+         "  -u              write the golden file instead of comparing\n"
+         "  -p              use paddles on port 0, driven as Stelladaptor axes\n"
+         "  -o key=value    set a core option\n",
+         argv0);
+}
+
+int main(int argc, char *argv[])
+{
+   bool update          = false;
+   bool paddles         = false;
+   const char *args[3]  = { NULL, NULL, NULL };
+   unsigned num_args    = 0;
+   unsigned frames, i;
+   unsigned check_errors = 0;
+   std::vector<uint8_t> rom;
+   std::vector<std::string> lines;
+   FILE *fp;
+
+   for (i = 1; i < (unsigned)argc; i++)
+   {
+      if (!strcmp(argv[i], "-u"))
+         update = true;
+      else if (!strcmp(argv[i], "-p"))
+         paddles = true;
+      else if (!strcmp(argv[i], "-o") && i + 1 < (unsigned)argc)
+      {
+         if (!headless_add_option(argv[++i]))
+         {
+            regress_usage(argv[0]);
+            return 2;
+         }
+      }
+      else if (argv[i][0] != '-' && num_args < 3)
+         args[num_args++] = argv[i];
+      else
+      {
+         regress_usage(argv[0]);
+         return 2;
+      }
+   }
+
+   if (num_args != 3 || (frames = strtoul(args[1], NULL, 10)) == 0)
+   {
+      regress_usage(argv[0]);
+      return 2;
+   }
+
+   if (paddles && !regress_use_paddles(args[0]))
+   {
+      fprintf(stderr, "Could not read ROM '%s'\n", args[0]);
+      return 2;
+   }
+
+   if (!headless_start(args[0], rom))
+      return 2;
+
+   if (paddles)
+      retro_set_controller_port_device(0, RETROPAD_STELLA_PADDLES);
+
+   retro_set_video_refresh(regress_video);
+   retro_set_audio_sample_batch(regress_audio_batch);
+   retro_set_input_poll(regress_input_poll);
+   console->tia().setScanlineCallback(regress_scanline, NULL);
+
+   for (i = 0; i < frames; i++)
+   {
+      TIA& tia = console->tia();
+      char line[80];
+
+      headless_joypad[0] = regress_input(i);
+      headless_joypad[1] = regress_input(i + 12 * 24 / 2);
+      headless_analog[0][0] = regress_paddle(i);
+      headless_analog[0][1] = regress_paddle(i + 200 - 50);
+
+      regress_video_hash = regress_audio_hash = REGRESS_HASH_INIT;
+      regress_lines = regress_late_lines = regress_unconverted_lines = 0;
+      regress_polls = regress_late_polls = 0;
+      retro_run();
+
+      uint64_t tia_hash = regress_hash(REGRESS_HASH_INIT,
+            tia.currentFrameBuffer(), tia.width() * tia.height());
+      if (tia.renderingEnabled() &&
+          (regress_lines != tia.height() || regress_lines_hash != tia_hash))
+      {
+         fprintf(stderr, "%s: frame %u: scanline callback disagrees with the frame buffer\n",
+               args[0], i);
+         check_errors++;
+      }
+      if (regress_late_lines)
+      {
+         fprintf(stderr, "%s: frame %u: %u scanlines were reported late\n",
+               args[0], i, regress_late_lines);
+         check_errors++;
+      }
+      if (regress_unconverted_lines)
+      {
+         fprintf(stderr, "%s: frame %u: %u scanlines were reported before their direct output\n",
+               args[0], i, regress_unconverted_lines);
+         check_errors++;
+      }
+      if (regress_late_polls)
+      {
+         fprintf(stderr, "%s: frame %u: %u input polls came late in the frame\n",
+               args[0], i, regress_late_polls);
+         check_errors++;
+      }
+      if (direct_video && tia.renderingEnabled() &&
+          !regress_direct_video_matches(tia))
+      {
+         fprintf(stderr, "%s: frame %u: direct video output disagrees with the frame buffer\n",
+               args[0], i);
+         check_errors++;
+      }
+
+      snprintf(line, sizeof(line), "%u %016llx %016llx %016llx", i,
+            (unsigned long long)tia_hash,
+            (unsigned long long)regress_video_hash,
+            (unsigned long long)regress_audio_hash);
+      lines.push_back(line);
+   }
+
+   retro_unload_game();
+   retro_deinit();
+
+   if (check_errors)
+      return 1;
+
+   if (update)
+   {
+      if (!(fp = fopen(args[2], "w")))
+      {
+         fprintf(stderr, "Could not write '%s'\n", args[2]);
+         return 2;
+      }
+      fprintf(fp, "# frame tia video audio\n");
+      for (i = 0; i < lines.size(); i++)
+         fprintf(fp, "%s\n", lines[i].c_str());
+      fclose(fp);
+      return 0;
+   }
+
+   if (!(fp = fopen(args[2], "r")))
+   {
+      fprintf(stderr, "Could not read '%s'\n", args[2]);
+      return 2;
+   }
+
+   {
+      static const char *streams[] = { "tia", "video", "audio" };
+      char golden[128];
+      unsigned frame = 0, mismatches = 0;
+
+      while (fgets(golden, sizeof(golden), fp) && frame < lines.size())
+      {
+         char *actual = &lines[frame][0];
+         char *g = golden, *a = actual;
+         unsigned field;
+
+         if (golden[0] == '#')
+            continue;
+         golden[strcspn(golden, "\r\n")] = '\0';
+
+         if (strcmp(golden, actual))
+         {
+            /* Name the first stream that differs */
+            g = strchr(g, ' ');
+            a = strchr(a, ' ');
+            for (field = 0; g && a && field < 3; field++)
+            {
+               if (strncmp(g, a, 17))
+                  break;
+               g = strchr(g + 1, ' ');
+               a = strchr(a + 1, ' ');
+            }
+            if (mismatches++ < 5)
+               fprintf(stderr, "%s: frame %u: %s hash differs\n",
+                     args[0], frame, field < 3 ? streams[field] : "frame");
+         }
+         frame++;
+      }
+      fclose(fp);
+
+      if (frame != lines.size())
+      {
+         fprintf(stderr, "%s: golden file has %u frames, expected %u\n",
+               args[0], frame, (unsigned)lines.size());
+         return 1;
+      }
+
+      if (mismatches)
+      {
+         fprintf(stderr, "%s: %u of %u frames differ\n",
+               args[0], mismatches, frame);
+         return 1;
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+# Minimal two-pass 6502 assembler used to build the regression test ROMs.
+#
+# Syntax (one statement per line, ';' starts a comment):
+#   name = expr            equate
+#   label:                 label (may be followed by a statement)
+#   .org expr              set the location counter
+#   .byte expr, ...        emit bytes
+#   .word expr, ...        emit little-endian words
+#   .align expr [, fill]   pad to a multiple of expr
+#   .fill count [, value]  emit count copies of value
+#   mnemonic [operand]     instruction
+#
+# Expressions use '$' for hex, '%' for binary, '<' / '>' for the low / high
+# byte and otherwise follow Python operator syntax.
+
+import re
+
+OPCODES = {
+    'ADC': {'imm': 0x69, 'zp': 0x65, 'zpx': 0x75, 'abs': 0x6D, 'absx': 0x7D, 'absy': 0x79, 'indx': 0x61, 'indy': 0x71},
+    'AND': {'imm': 0x29, 'zp': 0x25, 'zpx': 0x35, 'abs': 0x2D, 'absx': 0x3D, 'absy': 0x39, 'indx': 0x21, 'indy': 0x31},
+    'ASL': {'acc': 0x0A, 'zp': 0x06, 'zpx': 0x16, 'abs': 0x0E, 'absx': 0x1E},
+    'BCC': {'rel': 0x90}, 'BCS': {'rel': 0xB0}, 'BEQ': {'rel': 0xF0}, 'BMI': {'rel': 0x30},
+    'BNE': {'rel': 0xD0}, 'BPL': {'rel': 0x10}, 'BVC': {'rel': 0x50}, 'BVS': {'rel': 0x70},
+    'BIT': {'zp': 0x24, 'abs': 0x2C},
+    'BRK': {'imp': 0x00},
+    'CLC': {'imp': 0x18}, 'CLD': {'imp': 0xD8}, 'CLI': {'imp': 0x58}, 'CLV': {'imp': 0xB8},
+    'CMP': {'imm': 0xC9, 'zp': 0xC5, 'zpx': 0xD5, 'abs': 0xCD, 'absx': 0xDD, 'absy': 0xD9, 'indx': 0xC1, 'indy': 0xD1},
+    'CPX': {'imm': 0xE0, 'zp': 0xE4, 'abs': 0xEC},
+    'CPY': {'imm': 0xC0, 'zp': 0xC4, 'abs': 0xCC},
+    'DEC': {'zp': 0xC6, 'zpx': 0xD6, 'abs': 0xCE, 'absx': 0xDE},
+    'DEX': {'imp': 0xCA}, 'DEY': {'imp': 0x88},
+    'EOR': {'imm': 0x49, 'zp': 0x45, 'zpx': 0x55, 'abs': 0x4D, 'absx': 0x5D, 'absy': 0x59, 'indx': 0x41, 'indy': 0x51},
+    'INC': {'zp': 0xE6, 'zpx': 0xF6, 'abs': 0xEE, 'absx': 0xFE},
+    'INX': {'imp': 0xE8}, 'INY': {'imp': 0xC8},
+    'JMP': {'abs': 0x4C, 'ind': 0x6C},
+    'JSR': {'abs': 0x20},
+    'LDA': {'imm': 0xA9, 'zp': 0xA5, 'zpx': 0xB5, 'abs': 0xAD, 'absx': 0xBD, 'absy': 0xB9, 'indx': 0xA1, 'indy': 0xB1},
+    'LDX': {'imm': 0xA2, 'zp': 0xA6, 'zpy': 0xB6, 'abs': 0xAE, 'absy': 0xBE},
+    'LDY': {'imm': 0xA0, 'zp': 0xA4, 'zpx': 0xB4, 'abs': 0xAC, 'absx': 0xBC},
+    'LSR': {'acc': 0x4A, 'zp': 0x46, 'zpx': 0x56, 'abs': 0x4E, 'absx': 0x5E},
+    'NOP': {'imp': 0xEA, 'zp': 0x04},
+    'ORA': {'imm': 0x09, 'zp': 0x05, 'zpx': 0x15, 'abs': 0x0D, 'absx': 0x1D, 'absy': 0x19, 'indx': 0x01, 'indy': 0x11},
+    'PHA': {'imp': 0x48}, 'PHP': {'imp': 0x08}, 'PLA': {'imp': 0x68}, 'PLP': {'imp': 0x28},
+    'ROL': {'acc': 0x2A, 'zp': 0x26, 'zpx': 0x36, 'abs': 0x2E, 'absx': 0x3E},
+    'ROR': {'acc': 0x6A, 'zp': 0x66, 'zpx': 0x76, 'abs': 0x6E, 'absx': 0x7E},
+    'RTI': {'imp': 0x40}, 'RTS': {'imp': 0x60},
+    'SBC': {'imm': 0xE9, 'zp': 0xE5, 'zpx': 0xF5, 'abs': 0xED, 'absx': 0xFD, 'absy': 0xF9, 'indx': 0xE1, 'indy': 0xF1},
+    'SEC': {'imp': 0x38}, 'SED': {'imp': 0xF8}, 'SEI': {'imp': 0x78},
+    'STA': {'zp': 0x85, 'zpx': 0x95, 'abs': 0x8D, 'absx': 0x9D, 'absy': 0x99, 'indx': 0x81, 'indy': 0x91},
+    'STX': {'zp': 0x86, 'zpy': 0x96, 'abs': 0x8E},
+    'STY': {'zp': 0x84, 'zpx': 0x94, 'abs': 0x8C},
+    'TAX': {'imp': 0xAA}, 'TAY': {'imp': 0xA8}, 'TSX': {'imp': 0xBA}, 'TXA': {'imp': 0x8A},
+    'TXS': {'imp': 0x9A}, 'TYA': {'imp': 0x98},
+    # Undocumented opcodes used by real cartridges
+    'LAX': {'zp': 0xA7, 'zpy': 0xB7, 'abs': 0xAF, 'absy': 0xBF, 'indx': 0xA3, 'indy': 0xB3},
+    'SAX': {'zp': 0x87, 'zpy': 0x97, 'abs': 0x8F, 'indx': 0x83},
+    'DCP': {'zp': 0xC7, 'zpx': 0xD7, 'abs': 0xCF},
+    'ISB': {'zp': 0xE7, 'zpx': 0xF7, 'abs': 0xEF},
+    'SLO': {'zp': 0x07, 'abs': 0x0F},
+    'RLA': {'zp': 0x27, 'abs': 0x2F},
+    'SRE': {'zp': 0x47, 'abs': 0x4F},
+    'RRA': {'zp': 0x67, 'abs': 0x6F},
+    'ANC': {'imm': 0x0B}, 'ALR': {'imm': 0x4B}, 'ARR': {'imm': 0x6B}, 'SBX': {'imm': 0xCB},
+}
+
+SIZE = {'imp': 1, 'acc': 1, 'imm': 2, 'zp': 2, 'zpx': 2, 'zpy': 2, 'rel': 2,
+        'indx': 2, 'indy': 2, 'abs': 3, 'absx': 3, 'absy': 3, 'ind': 3}
+
+
+class AsmError(Exception):
+    pass
+
+
+class Assembler:
+    def __init__(self, size, base):
+        self.size = size
+        self.base = base
+
+    def _eval(self, expr, final):
+        e = expr.strip()
+        lo = hi = False
+        if e.startswith('<'):
+            lo, e = True, e[1:]
+        elif e.startswith('>'):
+            hi, e = True, e[1:]
+        e = re.sub(r'\$([0-9A-Fa-f]+)', r'0x\1', e)
+        e = re.sub(r'%([01]+)', r'0b\1', e)
+        try:
+            v = eval(e, {'__builtins__': {}}, self.symbols)
+        except NameError:
+            if final:
+                raise AsmError('undefined symbol in "%s"' % expr)
+            return None
+        if lo:
+            v &= 0xff
+        if hi:
+            v = (v >> 8) & 0xff
+        return v
+
+    def _parse_operand(self, mnem, arg):
+        modes = OPCODES[mnem]
+        if arg is None or arg == '':
+            return ('acc' if 'acc' in modes else 'imp'), None
+        if arg.upper() == 'A':
+            return 'acc', None
+        if arg.startswith('#'):
+            return 'imm', arg[1:]
+        m = re.match(r'^\((.*),\s*[Xx]\)$', arg)
+        if m:
+            return 'indx', m.group(1)
+        m = re.match(r'^\((.*)\),\s*[Yy]$', arg)
+        if m:
+            return 'indy', m.group(1)
+        m = re.match(r'^\((.*)\)$', arg)
+        if m and 'ind' in modes:
+            return 'ind', m.group(1)
+        if 'rel' in modes:
+            return 'rel', arg
+        m = re.match(r'^(.*),\s*([XxYy])$', arg)
+        if m:
+            return 'idx' + m.group(2).lower(), m.group(1)
+        return 'dir', arg
+
+    def _pass(self, lines, final):
+        out = bytearray([0xff] * self.size) if final else None
+        pc = self.base
+        for lineno, raw in enumerate(lines, 1):
+            line = raw.split(';', 1)[0].strip()
+            if not line:
+                continue
+            m = re.match(r'^([A-Za-z_][A-Za-z0-9_]*):\s*(.*)$', line)
+            if m:
+                self.symbols[m.group(1)] = pc
+                line = m.group(2).strip()
+                if not line:
+                    continue
+            m = re.match(r'^([A-Za-z_][A-Za-z0-9_]*)\s*=\s*(.*)$', line)
+            if m:
+                v = self._eval(m.group(2), final)
+                if v is not None:
+                    self.symbols[m.group(1)] = v
+                continue
+
+            parts = line.split(None, 1)
+            op = parts[0].upper()
+            arg = parts[1].strip() if len(parts) > 1 else None
+            emit = []
+
+            try:
+                if op == '.ORG':
+                    pc = self._eval(arg, True)
+                    continue
+                elif op in ('.BYTE', '.WORD'):
+                    for item in arg.split(','):
+                        v = self._eval(item, final) or 0
+                        emit += [v & 0xff] if op == '.BYTE' else [v & 0xff, (v >> 8) & 0xff]
+                elif op == '.ALIGN':
+                    a = [self._eval(x, True) for x in arg.split(',')]
+                    fill = a[1] if len(a) > 1 else 0
+                    emit = [fill] * ((-pc) % a[0])
+                elif op == '.FILL':
+                    a = [self._eval(x, True) for x in arg.split(',')]
+                    emit = [a[1] if len(a) > 1 else 0] * a[0]
+                elif op in OPCODES:
+                    mode, expr = self._parse_operand(op, arg)
+                    modes = OPCODES[op]
+                    v = self._eval(expr, final) if expr is not None else None
+                    if mode in ('dir', 'idxx', 'idxy'):
+                        suffix = {'dir': '', 'idxx': 'x', 'idxy': 'y'}[mode]
+                        small = v is not None and v < 0x100
+                        if small and ('zp' + suffix) in modes:
+                            mode = 'zp' + suffix
+                        elif ('abs' + suffix) in modes:
+                            mode = 'abs' + suffix
+                        else:
+                            mode = 'zp' + suffix
+                    if mode not in modes:
+                        raise AsmError('bad addressing mode for %s' % op)
+                    v = v or 0
+                    emit = [modes[mode]]
+                    if mode == 'rel':
+                        d = v - (pc + 2)
+                        if final and not -128 <= d <= 127:
+                            raise AsmError('branch out of range')
+                        emit.append(d & 0xff)
+                    elif SIZE[mode] == 2:
+                        emit.append(v & 0xff)
+                    elif SIZE[mode] == 3:
+                        emit += [v & 0xff, (v >> 8) & 0xff]
+                else:
+                    raise AsmError('unknown statement "%s"' % op)
+            except AsmError as e:
+                raise AsmError('line %d: %s: %s' % (lineno, e, raw.strip()))
+
+            if final:
+                off = (pc - self.base) & 0xffff
+                if off + len(emit) > self.size:
+                    raise AsmError('line %d: code outside image' % lineno)
+                out[off:off + len(emit)] = bytes(emit)
+            pc += len(emit)
+        return out
+
+    def assemble(self, source, symbols=None):
+        self.symbols = dict(symbols or {})
+        lines = source.splitlines()
+        self._pass(lines, False)
+        return bytes(self._pass(lines, True))
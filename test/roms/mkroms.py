@@ -0,0 +1,1272 @@
+#!/usr/bin/env python3
+# Builds the self-contained test ROMs used by the regression suite.
+#
+# The ROMs are small synthetic programs written for this test suite; each
+# one stresses a different part of the emulator (TIA objects and mid-line
+# writes, collisions, RIOT timer polling, sound registers, bankswitching,
+# self-modifying code in RAM, undocumented/decimal-mode CPU behaviour).
+# The generated .bin files are checked in, so this script only needs to
+# be run when a program below is changed (the golden files must then be
+# regenerated as well).
+
+import os
+import sys
+
+from asm6502 import Assembler
+
+HEADER = """
+VSYNC  = $00
+VBLANK = $01
+WSYNC  = $02
+RSYNC  = $03
+NUSIZ0 = $04
+NUSIZ1 = $05
+COLUP0 = $06
+COLUP1 = $07
+COLUPF = $08
+COLUBK = $09
+CTRLPF = $0A
+REFP0  = $0B
+REFP1  = $0C
+PF0    = $0D
+PF1    = $0E
+PF2    = $0F
+RESP0  = $10
+RESP1  = $11
+RESM0  = $12
+RESM1  = $13
+RESBL  = $14
+AUDC0  = $15
+AUDC1  = $16
+AUDF0  = $17
+AUDF1  = $18
+AUDV0  = $19
+AUDV1  = $1A
+GRP0   = $1B
+GRP1   = $1C
+ENAM0  = $1D
+ENAM1  = $1E
+ENABL  = $1F
+HMP0   = $20
+HMP1   = $21
+HMM0   = $22
+HMM1   = $23
+HMBL   = $24
+VDELP0 = $25
+VDELP1 = $26
+VDELBL = $27
+RESMP0 = $28
+RESMP1 = $29
+HMOVE  = $2A
+HMCLR  = $2B
+CXCLR  = $2C
+
+CXM0P  = $00
+CXM1P  = $01
+CXP0FB = $02
+CXP1FB = $03
+CXM0FB = $04
+CXM1FB = $05
+CXBLPF = $06
+CXPPMM = $07
+INPT0  = $08
+INPT1  = $09
+INPT4  = $0C
+INPT5  = $0D
+
+SWCHA  = $0280
+SWACNT = $0281
+SWCHB  = $0282
+INTIM  = $0284
+TIMINT = $0285
+TIM1T  = $0294
+TIM8T  = $0295
+TIM64T = $0296
+T1024T = $0297
+
+frame  = $80
+posx0  = $81
+posy0  = $82
+posx1  = $83
+colp0  = $84
+tmp    = $85
+score  = $86
+hits   = $8C
+sum    = $88
+ptr    = $8A
+idx    = $8E
+"""
+
+# Common power-on code: clear TIA registers and RAM, set up the stack
+CLEAR = """
+        sei
+        cld
+        ldx #0
+        txa
+clear:  sta $00,x
+        inx
+        bne clear
+        dex
+        txs
+"""
+
+# Standard 3-line VSYNC followed by the VBLANK timer
+VSYNC_START = """
+        lda #2
+        sta WSYNC
+        sta VSYNC
+        sta WSYNC
+        sta WSYNC
+        lda #0
+        sta WSYNC
+        sta VSYNC
+        lda #43
+        sta TIM64T
+"""
+
+WAIT_TIMER = """
+wait{n}: lda INTIM
+        bne wait{n}
+"""
+
+VECTORS = """
+        .org $FFFA
+        .word reset, reset, reset
+"""
+
+SPRITE = """
+sprite: .byte $18, $3C, $7E, $FF, $DB, $FF, $66, $C3
+        .byte $3C, $7E, $FF, $E7, $E7, $FF, $7E, $3C
+"""
+
+TABLES = """
+        .align 256
+pf0tab:
+""" + "".join("        .byte $%02X\n" % ((i * 0x1F) & 0xF0) for i in range(256)) + """
+pf1tab:
+""" + "".join("        .byte $%02X\n" % ((i * 0x35 + (i >> 3)) & 0xFF) for i in range(256)) + """
+pf2tab:
+""" + "".join("        .byte $%02X\n" % (((i ^ (i >> 2)) * 0x0B) & 0xFF) for i in range(256))
+
+
+# Position object at offset X (0..159) from the value in A; X selects
+# the object (0 = P0, 1 = P1, 2 = M0, 3 = M1, 4 = BL)
+POSITION = """
+posobj: sta WSYNC
+        sec
+posdiv: sbc #15
+        bcs posdiv
+        eor #7
+        asl
+        asl
+        asl
+        asl
+        sta HMP0,x
+        sta RESP0,x
+        rts
+"""
+
+
+# ---------------------------------------------------------------------------
+# kernel.bin: a conventional game-style frame using every TIA object,
+# joystick/console switch input, collisions and both sound channels.
+KERNEL = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+        lda #40
+        sta posx0
+        lda #60
+        sta posy0
+        lda #100
+        sta posx1
+        lda #$1E
+        sta colp0
+
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+
+        ; Joystick 0 moves player 0, fire changes its colour
+        lda SWCHA
+        bmi noright
+        inc posx0
+noright:
+        asl
+        bmi noleft
+        dec posx0
+noleft:
+        asl
+        bmi nodown
+        inc posy0
+nodown:
+        asl
+        bmi noup
+        dec posy0
+noup:
+        lda INPT4
+        bmi nofire
+        lda colp0
+        clc
+        adc #$10
+        sta colp0
+nofire:
+        ; Console reset switch recentres the player
+        lda SWCHB
+        lsr
+        bcs noreset
+        lda #80
+        sta posx0
+noreset:
+        lda posx0
+        cmp #152
+        bcc xok
+        lda #8
+        sta posx0
+xok:
+        ; Player 1 drifts, wrapping around
+        lda frame
+        and #1
+        clc
+        adc posx1
+        cmp #152
+        bcc x1ok
+        lda #0
+x1ok:   sta posx1
+
+        ; Sound: channel 0 sweeps through every AUDC mode
+        lda frame
+        lsr
+        lsr
+        lsr
+        and #$0F
+        sta AUDC0
+        lda frame
+        and #$1F
+        sta AUDF0
+        lda #$0A
+        sta AUDV0
+        lda frame
+        lsr
+        lsr
+        lsr
+        lsr
+        eor #$0C
+        sta AUDC1
+        lda frame
+        eor #$1F
+        sta AUDF1
+        lda frame
+        and #$0F
+        sta AUDV1
+
+        ; Horizontal positioning of every object
+        lda posx0
+        ldx #0
+        jsr posobj
+        lda posx1
+        ldx #1
+        jsr posobj
+        lda frame
+        and #$7F
+        ldx #2
+        jsr posobj
+        lda #140
+        sec
+        sbc posx0
+        ldx #3
+        jsr posobj
+        lda frame
+        lsr
+        adc #10
+        ldx #4
+        jsr posobj
+        sta WSYNC
+        sta HMOVE
+
+        ; Object attributes vary over time
+        lda frame
+        lsr
+        lsr
+        lsr
+        lsr
+        lsr
+        and #$07
+        sta NUSIZ1
+        lda frame
+        and #$37
+        sta CTRLPF
+        lda frame
+        sta REFP1
+        lda colp0
+        sta COLUP0
+        lda #$46
+        sta COLUP1
+        lda hits
+        sta COLUPF
+
+        ; Collision results from the previous frame
+        lda #0
+        bit CXPPMM
+        bpl nopp
+        ora #$40
+nopp:   bit CXP0FB
+        bpl nop0pf
+        ora #$20
+nop0pf: bit CXBLPF
+        bpl noblpf
+        ora #$10
+noblpf: ora #$08
+        sta hits
+        sta CXCLR
+        sta HMCLR
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        tya
+        adc frame
+        sta COLUBK
+        lda pf0tab,y
+        sta PF0
+        lda pf1tab,y
+        sta PF1
+        lda pf2tab,y
+        sta PF2
+        tya
+        sec
+        sbc posy0
+        cmp #16
+        bcc drawp0
+        lda #0
+        beq storep0
+drawp0: tax
+        lda sprite,x
+storep0:
+        sta GRP0
+        sta GRP1
+        tya
+        and #$06
+        sta ENAM0
+        lsr
+        sta ENABL
+        dey
+        bne line
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #0
+        sta GRP0
+        sta GRP1
+        lda #35
+        sta TIM64T
+
+        ; Decimal mode score keeping
+        sed
+        lda score
+        clc
+        adc #$01
+        sta score
+        lda score+1
+        adc #$00
+        sta score+1
+        cld
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + POSITION + SPRITE + TABLES + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# midline.bin: register writes at varying points within a scanline,
+# mid-line HMOVE, vertical delay, score/priority playfield modes and RSYNC.
+MIDLINE = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+        lda frame
+        and #$03
+        ora #$02
+        sta CTRLPF
+        lda #$0F
+        sta COLUP0
+        lda #$86
+        sta COLUP1
+        lda #$C4
+        sta COLUPF
+        lda frame
+        sta VDELP0
+        lsr
+        sta VDELP1
+        lsr
+        sta VDELBL
+        lda #$05
+        sta NUSIZ0
+        lda #$23
+        sta NUSIZ1
+        lda #$70
+        sta HMP0
+        lda #$90
+        sta HMP1
+        lda #$F0
+        sta HMBL
+        lda #$02
+        sta ENABL
+        lda #$5A
+        sta GRP1
+        lda frame
+        sta RESBL
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #0
+line:   sta WSYNC
+        ; RESP0 lands 0-3 loop iterations later depending on line + frame
+        tya
+        adc frame
+        and #$03
+        tax
+delay:  dex
+        bpl delay
+        sta RESP0
+        sty GRP0
+        lda pf1tab,y
+        sta PF1
+        sta RESP1
+        lda pf2tab,y
+        sta PF2
+        sty COLUBK
+        tya
+        and #$07
+        bne nohm
+        sta HMOVE
+nohm:   iny
+        cpy #96
+        bne line
+
+        ; second half: objects locked to players, reflected and stretched
+        lda #$02
+        sta RESMP0
+        sta RESMP1
+        lda #0
+        sta RESMP0
+        sta RESMP1
+        lda #$35
+        sta NUSIZ0
+        ldy #96
+line2:  sta WSYNC
+        sta HMOVE
+        tya
+        sta REFP0
+        sta ENAM0
+        eor #$FF
+        sta REFP1
+        sta ENAM1
+        sta GRP1
+        tya
+        asl
+        sta GRP0
+        lda pf2tab,y
+        sta PF2
+        sta PF1
+        cpy #$B0
+        bne norsync
+        sta RSYNC
+norsync:
+        iny
+        cpy #192
+        bne line2
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #0
+        sta ENABL
+        sta ENAM0
+        sta ENAM1
+        sta GRP0
+        sta GRP1
+        sta VDELP0
+        sta VDELP1
+        sta GRP0
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + TABLES + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# cpu.bin: exercises the 6502 core (every addressing mode, decimal mode,
+# stack, undocumented opcodes) and shows a running checksum on screen.
+CPU = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+        ; Indirect pointer into the data tables
+        lda frame
+        sta ptr
+        lda #>pf1tab
+        sta ptr+1
+
+        ldx #0
+        stx idx
+        ldy frame
+mix:    lda pf0tab,x
+        adc (ptr),y
+        eor pf2tab,y
+        sta tmp
+        ror sum
+        rol sum+1
+        lda (ptr,x)
+        sbc tmp
+        sta sum
+        asl tmp
+        lsr tmp
+        bit tmp
+        bvc novf
+        inc sum+1
+novf:   dec tmp
+        inc tmp,x
+        cmp tmp
+        cpx #$40
+        cpy tmp
+        php
+        pla
+        eor sum
+        sta sum
+        ; decimal mode add/subtract
+        sed
+        lda sum
+        adc sum+1
+        sta sum+1
+        sbc #$27
+        sta sum
+        cld
+        ; undocumented opcodes
+        lax sum
+        sax tmp
+        dcp tmp
+        isb tmp
+        slo tmp
+        rla tmp
+        sre tmp
+        rra tmp
+        anc #$C3
+        alr #$7E
+        arr #$A5
+        sbx #$11
+        sta sum+1
+        iny
+        lda idx
+        clc
+        adc #32
+        sta idx
+        tax
+        bne mix
+
+        lda sum
+        sta COLUPF
+        lda sum+1
+        sta COLUP0
+        jsr sub1
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        lda sum
+        sta PF0
+        lda sum+1
+        sta PF1
+        tya
+        eor sum
+        sta PF2
+        sta GRP0
+        tya
+        adc sum
+        sta COLUBK
+        dey
+        bne line
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+
+        ; nested subroutines and stack manipulation
+sub1:   lda sum
+        pha
+        jsr sub2
+        pla
+        eor sum
+        sta sum
+        rts
+sub2:   tsx
+        stx tmp
+        lda #$5A
+        pha
+        pla
+        ldx tmp
+        txs
+        rts
+""" + TABLES + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# ramcode.bin: copies a routine into RAM and executes it every scanline,
+# rewriting its own immediate operand as it runs.
+RAMCODE = HEADER + """
+ramsub = $C0
+        .org $F000
+reset:
+""" + CLEAR + """
+        ldx #(romsub_end - romsub - 1)
+copy:   lda romsub,x
+        sta ramsub,x
+        dex
+        bpl copy
+
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+        lda frame
+        sta ramsub+1
+        lda #$5C
+        sta COLUPF
+        lda #$33
+        sta PF1
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        jsr ramsub
+        tya
+        and #$1F
+        bne nopatch
+        ; patch the store target between COLUBK and COLUPF
+        lda ramsub+3
+        eor #(COLUBK ^ COLUPF)
+        sta ramsub+3
+nopatch:
+        dey
+        bne line
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+
+romsub: lda #$00
+        sta COLUBK
+        inc ramsub+1
+        rts
+romsub_end:
+""" + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# audio.bin: rewrites the sound registers many times per frame, at
+# irregular scanlines, so register changes land mid-fragment.
+AUDIO = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        tya
+        and #$1F
+        bne nosnd
+        ; every 32 lines: new tone on both channels
+        tya
+        adc frame
+        sta AUDF0
+        lsr
+        sta AUDC0
+        eor frame
+        sta AUDC1
+        sta AUDF1
+        lda frame
+        and #$0F
+        sta AUDV0
+        eor #$0F
+        sta AUDV1
+        sta COLUBK
+nosnd:  tya
+        and #$2F
+        cmp #$07
+        bne novol
+        ; odd position volume blips
+        lda frame
+        lsr
+        sta AUDV0
+novol:  dey
+        bne line
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# samples.bin: plays "samples" by writing the volume of both channels a
+# dozen times on every visible line, over 2000 writes a frame, as games
+# playing digitised sound do.
+SAMPLES = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+        lda #0
+        sta AUDC0
+        sta AUDC1
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        tya
+        clc
+        adc frame
+        tax
+""" + """        stx AUDV0
+        inx
+        stx AUDV1
+        inx
+""" * 6 + """        dey
+        bne line
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# paddles.bin: dumps the paddle capacitors during VBLANK and lets them
+# charge from the top of the picture.  The level of paddle 0 is shown as
+# the background colour twice a line and that of paddle 1 as the
+# playfield colour, so the frame shows where each one flips.
+PADDLES = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+        lda #$F0
+        sta PF0
+        lda #$FF
+        sta PF2
+frameloop:
+""" + VSYNC_START + """
+        lda #$82
+        sta VBLANK
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        lda INPT0
+        sta COLUBK
+        lda INPT1
+        sta COLUPF
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        nop
+        lda INPT0
+        ora #$0E
+        sta COLUBK
+        dey
+        bne line
+
+        lda #$82
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# bankf8.bin: 8K F8 cartridge whose frame code is split between both banks
+# and hops back and forth through a bankswitch trampoline.
+BANKF8_COMMON = """
+        .org $FFB0
+hop:    lda $FFF8
+        lda $FFF9
+        rts
+        .org $FFC0
+tobank0:
+        lda $FFF8
+        jmp bank0entry
+        .org $FFD0
+tobank1:
+        lda $FFF9
+        jmp bank1entry
+        .org $FFE0
+start:  lda $FFF8
+        jmp reset
+""" + """
+        .org $FFFA
+        .word start, start, start
+"""
+
+BANKF8_0 = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+bank0entry:
+""" + VSYNC_START + """
+        inc frame
+        lda frame
+        sta COLUPF
+        eor #$FF
+        sta COLUP0
+""" + WAIT_TIMER.format(n=0) + """
+        jmp tobank1
+bank1entry = $FFD6
+""" + TABLES + BANKF8_COMMON
+
+BANKF8_1 = HEADER + """
+bank0entry = $FFC6
+        .org $F000
+reset:
+bank1entry:
+        sta WSYNC
+        lda #0
+        sta VBLANK
+        ldy #192
+line:   sta WSYNC
+        lda pf0tab,y
+        sta PF0
+        lda pf1tab,y
+        sta PF1
+        sta GRP0
+        lda pf2tab,y
+        sta PF2
+        tya
+        eor frame
+        sta COLUBK
+        tya
+        and #$3F
+        bne nohop
+        ; swap banks and back within the visible frame
+        jsr hop
+nohop:  dey
+        bne line
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp tobank0
+""" + TABLES.replace("i * 0x1F", "i * 0x2F").replace("i * 0x35", "i * 0x17") + BANKF8_COMMON
+
+
+# ---------------------------------------------------------------------------
+# bankf8sc.bin: 8K F8 cartridge with the 128-byte Superchip RAM, running a
+# routine from the RAM read port that rewrites its own operands through the
+# write port, one of them just ahead of the instruction about to run it,
+# and a second routine whose operand the main loop rewrites.  Once in a
+# while a read of the write port stores the data bus into that operand
+# instead; the page-crossing dummy read before it drives the bus to $FF,
+# so the byte stored does not depend on the floating bus bits.
+BANKF8SC_COMMON = """
+        .org $FF00
+        .fill 16, $FF
+        .org $FFE0
+start:  lda $FFF8
+        jmp reset
+""" + """
+        .org $FFFA
+        .word start, start, start
+"""
+
+BANKF8SC_0 = HEADER + """
+ramw    = $F000
+ramr    = $F080
+        .org $F000
+        .fill 256, $FF
+reset:
+""" + CLEAR + """
+        ldx #(romsub_end - romsub - 1)
+copy:   lda romsub,x
+        sta ramw,x
+        dex
+        bpl copy
+        ldx #(romsub2_end - romsub2 - 1)
+copy2:  lda romsub2,x
+        sta ramw+$40,x
+        dex
+        bpl copy2
+
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+        lda frame
+        and #$07
+        bne nobus
+        ; store the driven data bus into the second routine's operand
+        ldx #$FF
+        lda ramw+$41-$FF,x
+        jmp busdone
+nobus:  lda frame
+        sta ramw+$41
+busdone:
+        lda #$33
+        sta PF1
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+
+        ldy #192
+line:   sta WSYNC
+        jsr ramr
+        jsr ramr+$40
+        dey
+        bne line
+
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #35
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+
+romsub: lda #$00
+        sta COLUBK
+        lda ramr+1
+        adc #3
+        sta ramw+1
+        sta ramw+(romsub_imm+1-romsub)
+        bit $FFF8
+romsub_imm:
+        lda #$00
+        sta COLUPF
+        rts
+romsub_end:
+
+romsub2:
+        lda #$00
+        sta PF2
+        rts
+romsub2_end:
+""" + BANKF8SC_COMMON
+
+BANKF8SC_1 = HEADER + """
+        .org $F000
+        .fill 256, $FF
+reset:
+        jmp start
+""" + BANKF8SC_COMMON
+
+
+# ---------------------------------------------------------------------------
+# pal.bin: a 312-line frame, so the core detects and runs it as PAL.
+PAL = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+frameloop:
+        lda #2
+        sta WSYNC
+        sta VSYNC
+        sta WSYNC
+        sta WSYNC
+        lda #0
+        sta WSYNC
+        sta VSYNC
+        lda #53
+        sta TIM64T
+        inc frame
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+        ldy #228
+line:   sta WSYNC
+        tya
+        eor frame
+        sta COLUBK
+        lda pf2tab,y
+        sta PF2
+        dey
+        bne line
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda #42
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + TABLES + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# lineend.bin: every scanline is drawn by an update that starts right at
+# the end of the previous line (where WSYNC leaves off) and runs on into
+# the next one, shifted by a line each frame so that such an update also
+# crosses the last visible line.
+LINEEND = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+frameloop:
+""" + VSYNC_START + """
+        inc frame
+        lda #$33
+        sta PF1
+""" + WAIT_TIMER.format(n=0) + """
+        sta WSYNC
+        lda #0
+        sta VBLANK
+        lda frame
+        and #3
+        tax
+skip0:  sta WSYNC
+        dex
+        bpl skip0
+
+        ldy #104
+line:   sta WSYNC
+        ; no TIA access for a line and a half
+        ldx #22
+delay:  dex
+        bne delay
+        tya
+        eor frame
+        sta COLUBK
+        asl
+        sta COLUPF
+        dey
+        bne line
+
+        lda frame
+        and #3
+        eor #3
+        tax
+skip1:  sta WSYNC
+        dex
+        bpl skip1
+        lda #2
+        sta VBLANK
+        lda #27
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+""" + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# frames.bin: after the first 64 frames, cycles through frames of varying
+# length: too short to be shown (VBLANK is first written as the frame
+# ends), running past the last scanline, and fewer lines than before.
+FRAMES = HEADER + """
+        .org $F000
+reset:
+""" + CLEAR + """
+frameloop:
+        lda #2
+        sta WSYNC
+        sta VSYNC
+        sta WSYNC
+        sta WSYNC
+        sta WSYNC
+        sta VBLANK
+        lda #0
+        sta VSYNC
+        lda #43
+        sta TIM64T
+        inc frame
+        ldx #0
+        lda frame
+        cmp #64
+        bcc normal
+        and #7
+        tax
+normal:
+""" + WAIT_TIMER.format(n=0) + """
+        lda lines,x
+        beq short
+        tay
+        sta WSYNC
+        lda #0
+        sta VBLANK
+line:   sta WSYNC
+        tya
+        eor frame
+        sta COLUBK
+        dey
+        bne line
+        lda #2
+        sta WSYNC
+        sta VBLANK
+        lda over,x
+        sta TIM64T
+""" + WAIT_TIMER.format(n=1) + """
+        jmp frameloop
+
+short:  ldy #24
+skip:   sta WSYNC
+        dey
+        bne skip
+        jmp frameloop
+
+lines:  .byte 192, 0, 192, 150, 192, 192, 0, 150
+over:   .byte 35, 35, 70, 35, 70, 35, 35, 35
+""" + VECTORS
+
+
+# ---------------------------------------------------------------------------
+# think.bin: keeps the CPU busy for most of every frame with nothing drawn
+# but the background, the way a game does while it "thinks": refills a
+# table from an LFSR and runs bubble sort passes over it until the timer
+# runs out.
+THINK = HEADER + """
+table  = $90
+        .org $F000
+reset:
+""" + CLEAR + """
+        lda #$A5
+        sta sum
+frameloop:
+        lda #2
+        sta WSYNC
+        sta VSYNC
+        sta WSYNC
+        sta WSYNC
+        lda #0
+        sta WSYNC
+        sta VSYNC
+        lda #15
+        sta T1024T
+        inc frame
+think:  jsr fill
+        jsr sortpass
+        jsr sortpass
+        lda INTIM
+        bne think
+        lda table
+        eor hits
+        sta COLUBK
+        lda #62
+        sta TIM64T
+""" + WAIT_TIMER.format(n=0) + """
+        jmp frameloop
+
+        ; 8-bit Galois LFSR fills the 32 byte table
+fill:   ldx #31
+        lda sum
+fillnext:
+        lsr
+        bcc nofeed
+        eor #$B8
+nofeed: sta table,x
+        dex
+        bpl fillnext
+        sta sum
+        rts
+
+        ; one bubble sort pass over the table, counting the swaps
+sortpass:
+        ldx #0
+sortnext:
+        lda table,x
+        cmp table+1,x
+        bcc inorder
+        ldy table+1,x
+        sta table+1,x
+        sty table,x
+        inc hits
+inorder:
+        inx
+        cpx #31
+        bne sortnext
+        rts
+""" + VECTORS
+
+
+ROMS = {
+    'kernel.bin':  [KERNEL],
+    'midline.bin': [MIDLINE],
+    'cpu.bin':     [CPU],
+    'ramcode.bin': [RAMCODE],
+    'audio.bin':   [AUDIO],
+    'samples.bin': [SAMPLES],
+    'bankf8.bin':  [BANKF8_0, BANKF8_1],
+    'bankf8sc.bin': [BANKF8SC_0, BANKF8SC_1],
+    'pal.bin':     [PAL],
+    'paddles.bin': [PADDLES],
+    'lineend.bin': [LINEEND],
+    'frames.bin':  [FRAMES],
+    'think.bin':   [THINK],
+}
+
+
+def main():
+    outdir = os.path.dirname(os.path.abspath(__file__))
+    for name, banks in sorted(ROMS.items()):
+        data = b''.join(Assembler(4096, 0xF000).assemble(src) for src in banks)
+        with open(os.path.join(outdir, name), 'wb') as f:
+            f.write(data)
+        print('%-12s %5d bytes' % (name, len(data)))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,50 @@
+#!/bin/sh
+# Runs every entry of corpus.txt through the regression test binary.
+#
+# Usage: run_tests.sh path/to/stella2014_regress
+# Set UPDATE=1 to regenerate the golden files instead of checking them.
+
+REGRESS="$1"
+DIR=$(dirname "$0")
+PASSED=0
+FAILED=0
+
+if [ -z "$REGRESS" ]; then
+   echo "Usage: $0 path/to/stella2014_regress" >&2
+   exit 2
+fi
+
+mkdir -p "$DIR/golden"
+
+while read -r name rom frames options; do
+   case "$name" in
+      ''|\#*) continue ;;
+   esac
+
+   args=""
+   for opt in $options; do
+      case "$opt" in
+         -*) args="$args $opt" ;;
+         *)  args="$args -o $opt" ;;
+      esac
+   done
+
+   if [ "$UPDATE" = "1" ]; then
+      "$REGRESS" -u $args "$DIR/roms/$rom" "$frames" "$DIR/golden/$name.txt" || exit 1
+      echo "updated $name"
+      continue
+   fi
+
+   if "$REGRESS" $args "$DIR/roms/$rom" "$frames" "$DIR/golden/$name.txt"; then
+      PASSED=$((PASSED + 1))
+      echo "PASS $name"
+   else
+      FAILED=$((FAILED + 1))
+      echo "FAIL $name"
+   fi
+done < "$DIR/corpus.txt"
+
+if [ "$UPDATE" != "1" ]; then
+   echo "$PASSED passed, $FAILED failed"
+   [ "$FAILED" -eq 0 ]
+fi
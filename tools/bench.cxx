@@ -0,0 +1,142 @@
+/* Headless benchmark for the Stella 2014 core.
+ *
+ * Drives the libretro interface without a frontend: a ROM is loaded from
+ * disk, retro_run() is called for a fixed number of frames with null
+ * video/audio/input callbacks, and the achieved emulation speed is reported.
+ *
+ * libretro.cxx is compiled into this translation unit so that the benchmark
+ * can query the emulated machine (scanline counts) without widening the
+ * exported core API.
+ *
+ * Usage: stella2014_bench [-f frames] [-w warmup] [-o key=value]... rom
+ */
+
+#include "../libretro.cxx"
+#include "headless.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static double bench_time_us(void)
+{
+#ifdef _WIN32
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER now;
+   if (!freq.QuadPart)
+      QueryPerformanceFrequency(&freq);
+   QueryPerformanceCounter(&now);
+   return (double)now.QuadPart * 1000000.0 / (double)freq.QuadPart;
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec / 1000.0;
+#endif
+}
+
+static void bench_usage(const char *argv0)
+{
+   fprintf(stderr,
+         "Usage: %s [-f frames] [-w warmup] [-o key=value]... rom\n"
+         "  -f frames       number of timed frames (default 3000)\n"
+         "  -w warmup       number of untimed frames run first (default 120)\n"
+         "  -o key=value    set a core option, e.g. -o stella2014_color_depth=24bit\n",
+         argv0);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned frames    = 3000;
+   unsigned warmup    = 120;
+   const char *path   = NULL;
+   std::vector<uint8_t> rom;
+   std::vector<double> frame_us;
+   double start, total_us;
+   uint64_t cycles = 0;
+   unsigned i;
+
+   for (i = 1; i < (unsigned)argc; i++)
+   {
+      if (!strcmp(argv[i], "-f") && i + 1 < (unsigned)argc)
+         frames = strtoul(argv[++i], NULL, 10);
+      else if (!strcmp(argv[i], "-w") && i + 1 < (unsigned)argc)
+         warmup = strtoul(argv[++i], NULL, 10);
+      else if (!strcmp(argv[i], "-o") && i + 1 < (unsigned)argc)
+      {
+         if (!headless_add_option(argv[++i]))
+         {
+            bench_usage(argv[0]);
+            return 1;
+         }
+      }
+      else if (argv[i][0] != '-' && !path)
+         path = argv[i];
+      else
+      {
+         bench_usage(argv[0]);
+         return 1;
+      }
+   }
+
+   if (!path || frames == 0)
+   {
+      bench_usage(argv[0]);
+      return 1;
+   }
+
+   if (!headless_start(path, rom))
+      return 1;
+
+   for (i = 0; i < warmup; i++)
+      retro_run();
+
+#ifdef STELLA_PROFILE
+   Profiler::reset();
+#endif
+
+   frame_us.resize(frames);
+   start = bench_time_us();
+   for (i = 0; i < frames; i++)
+   {
+      double t0 = bench_time_us();
+      retro_run();
+      frame_us[i] = bench_time_us() - t0;
+
+      // One scanline is 76 CPU cycles; the TIA reports the line count
+      // of the frame that has just been completed
+      cycles += (uint64_t)console->tia().scanlines() * 76;
+   }
+   total_us = bench_time_us() - start;
+
+   std::sort(frame_us.begin(), frame_us.end());
+
+   printf("rom:            %s\n", path);
+   printf("bankswitch:     %s\n", console->about().BankSwitch.c_str());
+   printf("display:        %s\n", console->about().DisplayFormat.c_str());
+   printf("frames:         %u (+%u warmup)\n", frames, warmup);
+   printf("scanlines:      %.1f per frame\n", cycles / 76.0 / frames);
+   printf("total time:     %.3f s\n", total_us / 1000000.0);
+   printf("frames/sec:     %.2f\n", frames * 1000000.0 / total_us);
+   printf("6507 cycles/s:  %.0f\n", cycles * 1000000.0 / total_us);
+   printf("frame time us:  min %.2f  median %.2f  p99 %.2f  max %.2f\n",
+         frame_us[0], frame_us[frames / 2],
+         frame_us[(size_t)((frames - 1) * 0.99)], frame_us[frames - 1]);
+
+#ifdef STELLA_PROFILE
+   if (Profiler::frames() > 0)
+   {
+      char report[512];
+      Profiler::report(report, sizeof(report));
+      printf("profile:        %s\n", report);
+   }
+#endif
+
+   retro_unload_game();
+   retro_deinit();
+
+   return 0;
+}
@@ -0,0 +1,289 @@
+/* Generator for the constant TIA tables.
+ *
+ * Computes the tables declared in TIATables.hxx and prints them as C++
+ * definitions, so that the core carries them as const data instead of
+ * building them in RAM every time a TIA is created.  The output is
+ * checked in as stella/src/emucore/TIATablesData.cxx; run
+ * "make tiatables" after changing anything here or in the mask row
+ * builders of TIATables.cxx.
+ *
+ * Usage: stella2014_gentables > TIATablesData.cxx
+ */
+
+#include "bspf.hxx"
+#include "TIATables.hxx"
+
+#include <stdio.h>
+#include <string.h>
+
+#define GEN_SEPARATOR \
+   "// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -\n"
+
+/* Values per line of the printed arrays */
+#define GEN_PER_LINE 16
+
+static uInt16 gen_collision_mask(uInt32 i)
+{
+   uInt16 mask = 0;
+
+   if ((i & M0Bit) && (i & P1Bit))    /* M0-P1 */
+      mask |= Cx_M0P1;
+   if ((i & M0Bit) && (i & P0Bit))    /* M0-P0 */
+      mask |= Cx_M0P0;
+   if ((i & M1Bit) && (i & P0Bit))    /* M1-P0 */
+      mask |= Cx_M1P0;
+   if ((i & M1Bit) && (i & P1Bit))    /* M1-P1 */
+      mask |= Cx_M1P1;
+   if ((i & P0Bit) && (i & PFBit))    /* P0-PF */
+      mask |= Cx_P0PF;
+   if ((i & P0Bit) && (i & BLBit))    /* P0-BL */
+      mask |= Cx_P0BL;
+   if ((i & P1Bit) && (i & PFBit))    /* P1-PF */
+      mask |= Cx_P1PF;
+   if ((i & P1Bit) && (i & BLBit))    /* P1-BL */
+      mask |= Cx_P1BL;
+   if ((i & M0Bit) && (i & PFBit))    /* M0-PF */
+      mask |= Cx_M0PF;
+   if ((i & M0Bit) && (i & BLBit))    /* M0-BL */
+      mask |= Cx_M0BL;
+   if ((i & M1Bit) && (i & PFBit))    /* M1-PF */
+      mask |= Cx_M1PF;
+   if ((i & M1Bit) && (i & BLBit))    /* M1-BL */
+      mask |= Cx_M1BL;
+   if ((i & BLBit) && (i & PFBit))    /* BL-PF */
+      mask |= Cx_BLPF;
+   if ((i & P0Bit) && (i & P1Bit))    /* P0-P1 */
+      mask |= Cx_P0P1;
+   if ((i & M0Bit) && (i & M1Bit))    /* M0-M1 */
+      mask |= Cx_M0M1;
+
+   return mask;
+}
+
+/* Playfield bit shown at pixel x, for non-reflected (0) and reflected (1)
+ * playfields */
+static uInt32 gen_pf_mask(uInt32 reflect, uInt32 x)
+{
+   if (x < 16)
+      return 0x00001 << (x >> 2);
+   else if (x < 48)
+      return 0x00800 >> ((x - 16) >> 2);
+   else if (x < 80)
+      return 0x01000 << ((x - 48) >> 2);
+
+   if (!reflect)
+   {
+      if (x < 96)
+         return 0x00001 << ((x - 80) >> 2);
+      else if (x < 128)
+         return 0x00800 >> ((x - 96) >> 2);
+      return 0x01000 << ((x - 128) >> 2);
+   }
+
+   if (x < 112)
+      return 0x80000 >> ((x - 80) >> 2);
+   else if (x < 144)
+      return 0x00010 << ((x - 112) >> 2);
+   return 0x00008 >> ((x - 144) >> 2);
+}
+
+static uInt8 gen_grp_reflect(uInt32 i)
+{
+   uInt8 r = 0;
+   uInt32 t;
+
+   for (t = 1; t <= 128; t <<= 1)
+      r = (r << 1) | ((i & t) ? 0x01 : 0x00);
+
+   return r;
+}
+
+/* Runs of non-zero entries in the first 160 entries of a mask row */
+static void gen_mask_runs(TIATables::MaskRuns& runs, const uInt8* mask)
+{
+   uInt32 x, end;
+
+   memset(&runs, 0, sizeof(runs));
+   for (x = 0; x < 160; x++)
+   {
+      if (!mask[x])
+         continue;
+
+      for (end = x + 1; end < 160 && mask[end]; end++);
+
+      /* Should never happen, but if a row has more runs than fit, fall
+       * back to a single run covering the whole row (always correct, just
+       * slower) */
+      if (runs.count == 8)
+      {
+         memset(&runs, 0, sizeof(runs));
+         runs.count    = 1;
+         runs.start[0] = 0;
+         runs.end[0]   = 160;
+         return;
+      }
+      runs.start[runs.count] = x;
+      runs.end[runs.count]   = end;
+      runs.count++;
+      x = end;
+   }
+}
+
+static void gen_values(const char *indent, const void *data, uInt32 size,
+      uInt32 count, const char *format)
+{
+   uInt32 i;
+
+   for (i = 0; i < count; i++)
+   {
+      uInt32 value = size == 1 ? ((const uInt8*)data)[i] :
+                     size == 2 ? ((const uInt16*)data)[i] :
+                                 ((const uInt32*)data)[i];
+
+      if (i % GEN_PER_LINE == 0)
+         printf("%s", indent);
+      printf(format, value);
+      printf(i + 1 == count ? "\n" : i % GEN_PER_LINE == GEN_PER_LINE - 1 ? ",\n" : ", ");
+   }
+}
+
+static void gen_runs(const char *indent, const TIATables::MaskRuns& runs, bool last)
+{
+   uInt32 i;
+
+   printf("%s{ %u, {", indent, runs.count);
+   for (i = 0; i < 8; i++)
+      printf(i ? ", %u" : " %u", runs.start[i]);
+   printf(" }, {");
+   for (i = 0; i < 8; i++)
+      printf(i ? ", %u" : " %u", runs.end[i]);
+   printf(" } }%s\n", last ? "" : ",");
+}
+
+int main(void)
+{
+   TIATables::MaskRuns runs;
+   uInt8 row[320], reflect[256];
+   uInt32 table[160];
+   uInt32 i, j, k;
+
+   printf("// Generated by tools/gen_tiatables.cxx (\"make tiatables\"); do not edit.\n\n");
+   printf("#include \"bspf.hxx\"\n");
+   printf("#include \"TIATables.hxx\"\n\n");
+
+   printf("#ifndef TIA_SMALL_TABLES\n");
+   printf(GEN_SEPARATOR);
+   printf("const uInt8 TIATables::PxMask[2][8][320] = {\n");
+   for (i = 0; i < 2; i++)
+   {
+      printf("  {\n");
+      for (j = 0; j < 8; j++)
+      {
+         TIATables::buildPxMaskRow(row, i, j);
+         printf("    {  // suppress %u, nusiz %u\n", i, j);
+         gen_values("      ", row, 1, 320, "0x%02x");
+         printf("    }%s\n", j < 7 ? "," : "");
+      }
+      printf("  }%s\n", i < 1 ? "," : "");
+   }
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const uInt8 TIATables::MxMask[8][5][320] = {\n");
+   for (i = 0; i < 8; i++)
+   {
+      printf("  {\n");
+      for (j = 0; j < 5; j++)
+      {
+         TIATables::buildMxMaskRow(row, i, j);
+         printf("    {  // number %u, size %u\n", i, j);
+         gen_values("      ", row, 1, 320, "%u");
+         printf("    }%s\n", j < 4 ? "," : "");
+      }
+      printf("  }%s\n", i < 7 ? "," : "");
+   }
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const uInt8 TIATables::BLMask[4][320] = {\n");
+   for (i = 0; i < 4; i++)
+   {
+      TIATables::buildBLMaskRow(row, i);
+      printf("  {  // size %u\n", i);
+      gen_values("    ", row, 1, 320, "%u");
+      printf("  }%s\n", i < 3 ? "," : "");
+   }
+   printf("};\n");
+   printf("#endif\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const TIATables::MaskRuns TIATables::PxMaskRuns[2][8] = {\n");
+   for (i = 0; i < 2; i++)
+   {
+      printf("  {\n");
+      for (j = 0; j < 8; j++)
+      {
+         TIATables::buildPxMaskRow(row, i, j);
+         gen_mask_runs(runs, row);
+         gen_runs("    ", runs, j == 7);
+      }
+      printf("  }%s\n", i < 1 ? "," : "");
+   }
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const TIATables::MaskRuns TIATables::MxMaskRuns[8][5] = {\n");
+   for (i = 0; i < 8; i++)
+   {
+      printf("  {\n");
+      for (j = 0; j < 5; j++)
+      {
+         TIATables::buildMxMaskRow(row, i, j);
+         gen_mask_runs(runs, row);
+         gen_runs("    ", runs, j == 4);
+      }
+      printf("  }%s\n", i < 7 ? "," : "");
+   }
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const TIATables::MaskRuns TIATables::BLMaskRuns[4] = {\n");
+   for (i = 0; i < 4; i++)
+   {
+      TIATables::buildBLMaskRow(row, i);
+      gen_mask_runs(runs, row);
+      gen_runs("  ", runs, i == 3);
+   }
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const uInt32 TIATables::PFMask[2][160] = {\n");
+   for (i = 0; i < 2; i++)
+   {
+      for (k = 0; k < 160; k++)
+         table[k] = gen_pf_mask(i, k);
+      printf("  {  // %s\n", i ? "reflected" : "not reflected");
+      gen_values("    ", table, 4, 160, "0x%05x");
+      printf("  }%s\n", i < 1 ? "," : "");
+   }
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const uInt8 TIATables::DisabledMask[640] = { 0 };\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const uInt16 TIATables::CollisionMask[64] = {\n");
+   for (k = 0; k < 64; k++)
+      table[k] = gen_collision_mask(k);
+   gen_values("  ", table, 4, 64, "0x%04x");
+   printf("};\n\n");
+
+   printf(GEN_SEPARATOR);
+   printf("const uInt8 TIATables::GRPReflect[256] = {\n");
+   for (k = 0; k < 256; k++)
+      reflect[k] = gen_grp_reflect(k);
+   gen_values("  ", reflect, 1, 256, "0x%02x");
+   printf("};\n");
+
+   return 0;
+}
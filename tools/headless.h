@@ -0,0 +1,158 @@
+/* Minimal libretro frontend shared by the headless tools.
+ *
+ * Must be included after libretro.cxx.  Provides an environment callback
+ * that accepts the pixel format and answers core options given on the
+ * command line, a stderr logger, null video/audio callbacks and a joypad
+ * and analog stick whose state is set directly by the tool.
+ */
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <vector>
+
+#define HEADLESS_MAX_OPTIONS 32
+
+static struct retro_variable headless_options[HEADLESS_MAX_OPTIONS];
+static unsigned headless_num_options = 0;
+
+/* RETRO_DEVICE_ID_JOYPAD_* bits currently held on each port */
+static uint16_t headless_joypad[MAX_RETROPAD_DEVICES];
+
+/* X and Y of the left analog stick on each port */
+static int16_t headless_analog[MAX_RETROPAD_DEVICES][2];
+
+/* Parses "key=value" in place; returns false if malformed or full */
+static bool headless_add_option(char *arg)
+{
+   char *sep = strchr(arg, '=');
+
+   if (!sep || headless_num_options == HEADLESS_MAX_OPTIONS)
+      return false;
+
+   *sep = '\0';
+   headless_options[headless_num_options].key   = arg;
+   headless_options[headless_num_options].value = sep + 1;
+   headless_num_options++;
+   return true;
+}
+
+static void headless_log(enum retro_log_level level, const char *fmt, ...)
+{
+   va_list ap;
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+static bool headless_environment(unsigned cmd, void *data)
+{
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+         ((struct retro_log_callback*)data)->log = headless_log;
+         return true;
+      case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+         return true;
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+         {
+            struct retro_variable *var = (struct retro_variable*)data;
+            unsigned i;
+            for (i = 0; i < headless_num_options; i++)
+               if (!strcmp(headless_options[i].key, var->key))
+               {
+                  var->value = headless_options[i].value;
+                  return true;
+               }
+         }
+         return false;
+      default:
+         return false;
+   }
+}
+
+static void headless_video(const void *data, unsigned width, unsigned height, size_t pitch) { }
+static void headless_audio(int16_t left, int16_t right) { }
+static size_t headless_audio_batch(const int16_t *data, size_t frames) { return frames; }
+static void headless_input_poll(void) { }
+
+static int16_t headless_input_state(unsigned port, unsigned device, unsigned index, unsigned id)
+{
+   if (port >= MAX_RETROPAD_DEVICES)
+      return 0;
+   if (device == RETRO_DEVICE_ANALOG)
+      return index == RETRO_DEVICE_INDEX_ANALOG_LEFT && id <= RETRO_DEVICE_ID_ANALOG_Y ?
+         headless_analog[port][id] : 0;
+   if (device != RETRO_DEVICE_JOYPAD || id > 15)
+      return 0;
+   return (headless_joypad[port] >> id) & 1;
+}
+
+static bool headless_load_file(const char *path, std::vector<uint8_t>& data)
+{
+   FILE *fp = fopen(path, "rb");
+   long size;
+
+   if (!fp)
+      return false;
+
+   fseek(fp, 0, SEEK_END);
+   size = ftell(fp);
+   fseek(fp, 0, SEEK_SET);
+
+   if (size <= 0)
+   {
+      fclose(fp);
+      return false;
+   }
+
+   data.resize(size);
+   if (fread(&data[0], 1, size, fp) != (size_t)size)
+   {
+      fclose(fp);
+      return false;
+   }
+
+   fclose(fp);
+   return true;
+}
+
+/* Installs the headless callbacks, initialises the core and loads the
+ * ROM; the tool may override the video/audio callbacks afterwards */
+static bool headless_start(const char *path, std::vector<uint8_t>& rom)
+{
+   struct retro_game_info info;
+
+   if (!headless_load_file(path, rom))
+   {
+      fprintf(stderr, "Could not read ROM '%s'\n", path);
+      return false;
+   }
+
+   retro_set_environment(headless_environment);
+   retro_set_video_refresh(headless_video);
+   retro_set_audio_sample(headless_audio);
+   retro_set_audio_sample_batch(headless_audio_batch);
+   retro_set_input_poll(headless_input_poll);
+   retro_set_input_state(headless_input_state);
+   retro_init();
+
+   info.path = path;
+   info.data = &rom[0];
+   info.size = rom.size();
+   info.meta = NULL;
+
+   if (!retro_load_game(&info))
+   {
+      fprintf(stderr, "Could not load ROM '%s'\n", path);
+      retro_deinit();
+      return false;
+   }
+
+   return true;
+}
+
+#endif